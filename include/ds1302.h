@@ -35,6 +35,29 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#ifndef DS1302_CENTURY_BASE
+/*!
+ * \brief First year of the century, which two digits year kept by DS1302
+ * belongs to. Leap years and epoch conversions are based on it.
+ */
+#define DS1302_CENTURY_BASE     (2000u)
+#endif
+
+#ifndef DS1302_SEVEN_SEGMENT
+/*!
+ * \brief Enables \ref DS1302_get_glyph and its 7-segment glyph table
+ */
+#define DS1302_SEVEN_SEGMENT    (0)
+#endif
+
+#ifndef DS1302_SEED_BUILD_TIMESTAMP
+/*!
+ * \brief \ref DS1302_configure seeds the clock with the build timestamp
+ * \ref DS1302_BUILD_FRAME, when oscillator is found halted
+ */
+#define DS1302_SEED_BUILD_TIMESTAMP     (1)
+#endif
+
 /*!
  *
  * \addtogroup ds1302_data_types
@@ -54,6 +77,206 @@
 #define DS1302_AM_PM            (9U)
 /*@}*/
 
+/*!
+ *
+ * \addtogroup ds1302_weekdays
+ * \ingroup ds1302
+ * \brief DS1302 days of the week, as used by calendar functions
+ */
+/*@{*/
+#define DS1302_MONDAY           (1u)
+#define DS1302_TUESDAY          (2u)
+#define DS1302_WEDNESDAY        (3u)
+#define DS1302_THURSDAY         (4u)
+#define DS1302_FRIDAY           (5u)
+#define DS1302_SATURDAY         (6u)
+#define DS1302_SUNDAY           (7u)
+/*@}*/
+
+/*!
+ * \brief Seconds between Unix epoch and the beginning of the century
+ * \ref DS1302_CENTURY_BASE, to be added to the result of \ref DS1302_to_epoch
+ */
+#define DS1302_UNIX_EPOCH_OFFSET        (86400UL * \
+        (365UL * (DS1302_CENTURY_BASE - 1970UL) + \
+        (DS1302_CENTURY_BASE - 1969UL) / 4UL - \
+        (DS1302_CENTURY_BASE - 1901UL) / 100UL + \
+        (DS1302_CENTURY_BASE - 1601UL) / 400UL))
+
+/*!
+ * \brief Packed timestamp, seconds since the beginning of the century
+ * \ref DS1302_CENTURY_BASE
+ *
+ * Integer ordering of timestamps matches chronological ordering, so
+ * timestamps are compared with single integer comparison. Field-wise layout
+ * (year:7, month:4, date:5, hours:5, minutes:6, seconds:6) takes 33 bits,
+ * hence seconds count is used to fit 32 bits.
+ */
+typedef uint32_t DS1302_timestamp_t;
+
+/*!
+ * \brief Timestamp returned for invalid input, later than any valid one as
+ * century takes less than 2^32 seconds
+ */
+#define DS1302_TIMESTAMP_INVALID        (UINT32_MAX)
+
+/*!
+ *
+ * \addtogroup ds1302_string_sizes
+ * \ingroup ds1302
+ * \brief Buffer sizes required by formatters, including terminating null
+ */
+/*@{*/
+#define DS1302_TIME_STRING_SIZE         (9u)  /*!< HH:MM:SS */
+#define DS1302_TIME_12H_STRING_SIZE     (12u) /*!< HH:MM:SS AM */
+#define DS1302_DATE_STRING_SIZE         (9u)  /*!< DD.MM.YY */
+#define DS1302_ISO8601_STRING_SIZE      (20u) /*!< YYYY-MM-DDTHH:MM:SS */
+/*@}*/
+
+/*!
+ * \brief Size of the clock burst frame, seven clock registers in
+ * device order (seconds, minutes, hours, date, month, weekday, year)
+ * followed by control register
+ */
+#define DS1302_FRAME_SIZE       (8u)
+
+/*!
+ *
+ * \addtogroup ds1302_frame_layout
+ * \ingroup ds1302
+ * \brief Positions of registers in the clock burst frame and masks of
+ * their BCD values
+ */
+/*@{*/
+#define DS1302_FRAME_SECONDS    (0u)
+#define DS1302_FRAME_MINUTES    (1u)
+#define DS1302_FRAME_HOURS      (2u)
+#define DS1302_FRAME_DATE       (3u)
+#define DS1302_FRAME_MONTH      (4u)
+#define DS1302_FRAME_WEEKDAY    (5u)
+#define DS1302_FRAME_YEAR       (6u)
+#define DS1302_FRAME_CONTROL    (7u)
+
+#define DS1302_SEC_MIN_MASK     (0x7Fu)
+#define DS1302_HOURS_24H_MASK   (0x3Fu)
+#define DS1302_HOURS_12H_MASK   (0x1Fu)
+#define DS1302_DATE_MASK        (0x3Fu)
+#define DS1302_MONTH_MASK       (0x1Fu)
+#define DS1302_WEEKDAY_MASK     (0x07u)
+#define DS1302_YEAR_MASK        (0xFFu)
+#define DS1302_FORMAT_MASK      (0x80u)
+#define DS1302_AM_PM_MASK       (0x20u)
+/*@}*/
+
+/*!
+ *
+ * \addtogroup ds1302_options
+ * \ingroup ds1302
+ * \brief DS1302 driver options, see \ref DS1302_set_option
+ */
+/*@{*/
+/*!
+ * \ref DS1302_set always writes seconds, minutes and hours, but writes
+ * date, month, day of the week and year only if they differ from the values
+ * last read or written, e.g. setting the time of the same day takes three
+ * single writes instead of a burst. Single burst is used, when the clock has
+ * not been read yet, it has been read in the last hour of the day or more
+ * than one calendar register changes. Calendar is assumed to stay as last
+ * read, so clock has to be read again on the day it is set.
+ */
+#define DS1302_OPTION_DIFF_WRITES       (0x01u)
+/*!
+ * Setters disable write protection only when needed and restore setting
+ * requested by \ref DS1302_set_write_protection afterwards, see also
+ * \ref DS1302_begin_batch
+ */
+#define DS1302_OPTION_AUTO_WRITE_PROTECTION     (0x02u)
+/*!
+ * \ref DS1302_set ignores weekday member of the aggregate and stores day of
+ * the week computed with \ref DS1302_compute_weekday instead
+ */
+#define DS1302_OPTION_AUTO_WEEKDAY      (0x04u)
+/*@}*/
+
+/*!
+ *
+ * \addtogroup ds1302_trickle_charger
+ * \ingroup ds1302
+ * \brief DS1302 trickle charger settings, diode and resistor settings
+ * are combined with \ref DS1302_TRICKLE_ENABLED
+ */
+/*@{*/
+#define DS1302_TRICKLE_DISABLED         (0x00u)
+#define DS1302_TRICKLE_ENABLED          (0xA0u)
+#define DS1302_TRICKLE_ONE_DIODE        (0x04u)
+#define DS1302_TRICKLE_TWO_DIODES       (0x08u)
+#define DS1302_TRICKLE_2K_RESISTOR      (0x01u)
+#define DS1302_TRICKLE_4K_RESISTOR      (0x02u)
+#define DS1302_TRICKLE_8K_RESISTOR      (0x03u)
+/*@}*/
+
+/*!
+ *
+ * \addtogroup ds1302_build_timestamp
+ * \ingroup ds1302
+ * \brief Build timestamp taken from __DATE__ and __TIME__ at compile time,
+ * constant expressions in C and C++, so no string is kept in flash
+ */
+/*@{*/
+#define DS1302_BUILD_DIGIT(str, i)      ((uint8_t)(((str)[i] == ' ') ? 0u : \
+                                        (uint8_t)((str)[i] - '0')))
+#define DS1302_BUILD_BCD(str, i)        ((uint8_t)((DS1302_BUILD_DIGIT(str, i) << 4u) | \
+                                        DS1302_BUILD_DIGIT(str, (i) + 1u)))
+#define DS1302_BUILD_NUMBER(str, i)     ((uint8_t)(DS1302_BUILD_DIGIT(str, i) * 10u + \
+                                        DS1302_BUILD_DIGIT(str, (i) + 1u)))
+
+#define DS1302_BUILD_FULL_YEAR          (DS1302_BUILD_NUMBER(__DATE__, 7u) * 100u + \
+                                        DS1302_BUILD_NUMBER(__DATE__, 9u))
+#define DS1302_BUILD_YEAR               DS1302_BUILD_NUMBER(__DATE__, 9u)
+#define DS1302_BUILD_MONTH              ((uint8_t)( \
+        (__DATE__[2] == 'n') ? ((__DATE__[1] == 'a') ? 1u : 6u) : \
+        (__DATE__[2] == 'b') ? 2u : \
+        (__DATE__[2] == 'r') ? ((__DATE__[0] == 'M') ? 3u : 4u) : \
+        (__DATE__[2] == 'y') ? 5u : \
+        (__DATE__[2] == 'l') ? 7u : \
+        (__DATE__[2] == 'g') ? 8u : \
+        (__DATE__[2] == 'p') ? 9u : \
+        (__DATE__[2] == 't') ? 10u : \
+        (__DATE__[2] == 'v') ? 11u : 12u))
+#define DS1302_BUILD_DATE               DS1302_BUILD_NUMBER(__DATE__, 4u)
+
+/*! Sakamoto's month offsets */
+#define DS1302_BUILD_MONTH_OFFSET(m)    ( \
+        ((m) == 1u) ? 0u : ((m) == 2u) ? 3u : ((m) == 3u) ? 2u : \
+        ((m) == 4u) ? 5u : ((m) == 5u) ? 0u : ((m) == 6u) ? 3u : \
+        ((m) == 7u) ? 5u : ((m) == 8u) ? 1u : ((m) == 9u) ? 4u : \
+        ((m) == 10u) ? 6u : ((m) == 11u) ? 2u : 4u)
+#define DS1302_BUILD_SAKAMOTO_YEAR      (DS1302_BUILD_FULL_YEAR - \
+                                        ((DS1302_BUILD_MONTH < 3u) ? 1u : 0u))
+/*! Day of the week, 0 is Sunday */
+#define DS1302_BUILD_SUNDAY_WEEKDAY     ((DS1302_BUILD_SAKAMOTO_YEAR + \
+        DS1302_BUILD_SAKAMOTO_YEAR / 4u - DS1302_BUILD_SAKAMOTO_YEAR / 100u + \
+        DS1302_BUILD_SAKAMOTO_YEAR / 400u + \
+        DS1302_BUILD_MONTH_OFFSET(DS1302_BUILD_MONTH) + DS1302_BUILD_DATE) % 7u)
+#define DS1302_BUILD_WEEKDAY            ((uint8_t)((DS1302_BUILD_SUNDAY_WEEKDAY == 0u) ? \
+                                        DS1302_SUNDAY : DS1302_BUILD_SUNDAY_WEEKDAY))
+
+/*!
+ * \brief Initializer of raw clock burst frame \ref DS1302_FRAME_SIZE holding
+ * the build timestamp in 24h format, ready for \ref DS1302_set_frame
+ */
+#define DS1302_BUILD_FRAME              { \
+        DS1302_BUILD_BCD(__TIME__, 6u), \
+        DS1302_BUILD_BCD(__TIME__, 3u), \
+        DS1302_BUILD_BCD(__TIME__, 0u), \
+        DS1302_BUILD_BCD(__DATE__, 4u), \
+        (uint8_t)((DS1302_BUILD_MONTH >= 10u) ? \
+                (0x10u | (DS1302_BUILD_MONTH - 10u)) : DS1302_BUILD_MONTH), \
+        DS1302_BUILD_WEEKDAY, \
+        DS1302_BUILD_BCD(__DATE__, 9u), \
+        0u }
+/*@}*/
+
 /*!
  * \brief Aggregate of DS1302 data types \ref ds1302_data_types
  */
@@ -71,30 +294,86 @@ typedef struct
 } DS1302_datetime_t;
 
 /*!
- * \todo (DB) refactor below getters into one function and rename it into something like 
- * DS1302_load_data(type)
- * */
+ * \brief Compact variant of \ref DS1302_datetime_t packed into bitfields,
+ * 6 bytes instead of 9, for keeping many dates in RAM
+ */
+typedef struct
+{
+    uint8_t secs : 6; /*!< Seconds */
+    uint8_t is_12h_mode : 1; /*!< 24h/12h mode */
+    uint8_t is_pm : 1; /*!< AM/PM in case 12h mode*/
+    uint8_t min : 6; /*!< Minutes */
+    uint8_t hours : 5; /*!< Hours */
+    uint8_t weekday : 3; /*!< Day of the week */
+    uint8_t date : 5; /*!< Day of the month */
+    uint8_t month : 4; /*!< Month */
+    uint8_t year : 7; /*!< Year */
+} DS1302_compact_t;
 
 /*!
- * \brief Gets seconds
+ * \brief Loads single data type straight from its DS1302 register
+ *
+ * \param type type of data \ref ds1302_data_types
  *
- * \returns Seconds
+ * \note Costs exactly one register read, no burst is involved
+ *
+ * \returns Value of the data type, \ref DS1302_FORMAT and \ref DS1302_AM_PM
+ * load as 0 or 1
  */
-uint8_t DS1302_get_seconds(void);
+uint8_t DS1302_load(uint8_t type);
 
 /*!
- * \brief Gets minutes
+ * \brief Stores single data type straight into its DS1302 register
+ *
+ * \param type type of data \ref ds1302_data_types
+ * \param val value to be stored, has to be within data type range
  *
- * \returns Minutes
+ * \note Data types sharing hours register are read-modified-written, storing
+ * \ref DS1302_HOURS_24H or \ref DS1302_HOURS_12H switches hours format as well,
+ * the latter keeping current half of the day. \ref DS1302_FORMAT converts
+ * hours as \ref DS1302_set_hours_format does and \ref DS1302_AM_PM moves
+ * hours by 12 in 24h format. Storing \ref DS1302_SECONDS clears clock halt bit. Write protection is
+ * bracketed according to \ref DS1302_OPTION_AUTO_WRITE_PROTECTION.
  */
-uint8_t DS1302_get_minutes(void);
+void DS1302_store(uint8_t type, uint8_t val);
+
+/*!
+ * \brief Table of data types owning whole register, used to generate
+ * DS1302_get_<name> and DS1302_set_<name> accessors
+ */
+#define DS1302_REGISTERS(X) \
+    X(seconds, DS1302_SECONDS) \
+    X(minutes, DS1302_MINUTES) \
+    X(weekday, DS1302_WEEKDAY) \
+    X(date, DS1302_DATE) \
+    X(month, DS1302_MONTH) \
+    X(year, DS1302_YEAR)
+
+#define DS1302_ACCESSORS(name, type) \
+    static inline uint8_t DS1302_get_##name(void) \
+    { \
+        return DS1302_load(type); \
+    } \
+    static inline void DS1302_set_##name(uint8_t val) \
+    { \
+        DS1302_store(type, val); \
+    }
+
+DS1302_REGISTERS(DS1302_ACCESSORS)
+
+#undef DS1302_ACCESSORS
 
 /*!
  * \brief Gets hours
  *
+ * \param is_12h_mode true if hours are expected in 12h format
+ *
  * \returns Hours
  */
-uint8_t DS1302_get_hours(bool is_12h_mode);
+static inline uint8_t DS1302_get_hours(bool is_12h_mode)
+{
+    return DS1302_load(is_12h_mode ? DS1302_HOURS_12H : DS1302_HOURS_24H);
+}
 
 /*!
  * \brief Gets minimum allowed setting of the data type
@@ -120,7 +399,8 @@ uint8_t DS1302_get_range_maximum(uint8_t type);
 /*!
  * \brief Gets maximum allowed setting for the day of the month \ref DS1302_DATE
  *
- * \param year year as input to calculate proper maximum value
+ * \param year year of the century \ref DS1302_CENTURY_BASE as input to
+ * calculate proper maximum value
  * \param month month as input to calculate proper maximum value
  *
  * \returns Maximum value of the day of the month
@@ -131,10 +411,13 @@ uint8_t DS1302_get_date_range_maximum(uint8_t year, uint8_t month);
  * \brief Enables/disables write protection of the DS1302
  *
  * \param val write protection setting, true enables write protection
+ *
+ * \note Write protection state is cached, so the register is written only
+ * when setting changes. With \ref DS1302_OPTION_AUTO_WRITE_PROTECTION the
+ * setting is the one restored after each write.
  */
 void DS1302_set_write_protection(bool val);
 
-/*! \todo (DB) change name of the function to DS1302_load */
 /*!
  * \brief Retrieves aggregate with all DS1302 data types
  *
@@ -142,16 +425,701 @@ void DS1302_set_write_protection(bool val);
  */
 void DS1302_get(DS1302_datetime_t *config);
 
-/*! \todo (DB) change name of the function to DS1302_store */
+/*!
+ * \brief Undecoded clock registers retrieved in single burst, fields are
+ * decoded only when asked for with DS1302_snapshot_<field> accessors
+ */
+typedef struct
+{
+    uint8_t regs[DS1302_FRAME_SIZE]; /*!< Clock burst frame \ref ds1302_frame_layout */
+} DS1302_snapshot_t;
+
+/*!
+ * \brief Retrieves coherent snapshot of clock registers
+ *
+ * \param snapshot storage for the snapshot
+ */
+void DS1302_get_snapshot(DS1302_snapshot_t *snapshot);
+
+/*!
+ * \brief Converts BCD code into binary value
+ *
+ * \param bcd value in BCD code
+ *
+ * \returns Binary value
+ */
+static inline uint8_t DS1302_bcd_to_bin(uint8_t bcd)
+{
+    const uint8_t tens = (uint8_t)(bcd >> 4u);
+
+    return (uint8_t)((bcd & 0x0Fu) + (tens << 3u) + (tens << 1u));
+}
+
+/*!
+ * \brief Gets seconds of the snapshot
+ */
+static inline uint8_t DS1302_snapshot_secs(const DS1302_snapshot_t *snapshot)
+{
+    return DS1302_bcd_to_bin(snapshot->regs[DS1302_FRAME_SECONDS] & DS1302_SEC_MIN_MASK);
+}
+
+/*!
+ * \brief Gets minutes of the snapshot
+ */
+static inline uint8_t DS1302_snapshot_min(const DS1302_snapshot_t *snapshot)
+{
+    return DS1302_bcd_to_bin(snapshot->regs[DS1302_FRAME_MINUTES] & DS1302_SEC_MIN_MASK);
+}
+
+/*!
+ * \brief Checks if hours of the snapshot are in 12h format
+ */
+static inline bool DS1302_snapshot_is_12h_mode(const DS1302_snapshot_t *snapshot)
+{
+    return ((snapshot->regs[DS1302_FRAME_HOURS] & DS1302_FORMAT_MASK) != 0u);
+}
+
+/*!
+ * \brief Checks if hours of the snapshot are PM, false in 24h format
+ */
+static inline bool DS1302_snapshot_is_pm(const DS1302_snapshot_t *snapshot)
+{
+    return DS1302_snapshot_is_12h_mode(snapshot) &&
+        ((snapshot->regs[DS1302_FRAME_HOURS] & DS1302_AM_PM_MASK) != 0u);
+}
+
+/*!
+ * \brief Gets hours of the snapshot in the format held by DS1302
+ */
+static inline uint8_t DS1302_snapshot_hours(const DS1302_snapshot_t *snapshot)
+{
+    const uint8_t mask = DS1302_snapshot_is_12h_mode(snapshot) ?
+        DS1302_HOURS_12H_MASK : DS1302_HOURS_24H_MASK;
+
+    return DS1302_bcd_to_bin(snapshot->regs[DS1302_FRAME_HOURS] & mask);
+}
+
+/*!
+ * \brief Gets day of the week of the snapshot
+ */
+static inline uint8_t DS1302_snapshot_weekday(const DS1302_snapshot_t *snapshot)
+{
+    return (uint8_t)(snapshot->regs[DS1302_FRAME_WEEKDAY] & DS1302_WEEKDAY_MASK);
+}
+
+/*!
+ * \brief Gets day of the month of the snapshot
+ */
+static inline uint8_t DS1302_snapshot_date(const DS1302_snapshot_t *snapshot)
+{
+    return DS1302_bcd_to_bin(snapshot->regs[DS1302_FRAME_DATE] & DS1302_DATE_MASK);
+}
+
+/*!
+ * \brief Gets month of the snapshot
+ */
+static inline uint8_t DS1302_snapshot_month(const DS1302_snapshot_t *snapshot)
+{
+    return DS1302_bcd_to_bin(snapshot->regs[DS1302_FRAME_MONTH] & DS1302_MONTH_MASK);
+}
+
+/*!
+ * \brief Gets year of the snapshot
+ */
+static inline uint8_t DS1302_snapshot_year(const DS1302_snapshot_t *snapshot)
+{
+    return DS1302_bcd_to_bin(snapshot->regs[DS1302_FRAME_YEAR] & DS1302_YEAR_MASK);
+}
+
+/*!
+ *
+ * \addtogroup ds1302_display
+ * \ingroup ds1302
+ * \brief Digits for displays taken straight from BCD registers, only masks
+ * and shifts are involved
+ */
+/*@{*/
+#define DS1302_TENS(bcd)        ((uint8_t)((bcd) >> 4u))
+#define DS1302_UNITS(bcd)       ((uint8_t)((bcd) & 0x0Fu))
+
+/*!
+ * \brief Gets BCD value of the snapshot register, stripped of control bits
+ *
+ * \param snapshot snapshot retrieved with \ref DS1302_get_snapshot
+ * \param index position of the register \ref ds1302_frame_layout
+ *
+ * \note Hours are given in the format held by DS1302. Use \ref DS1302_TENS
+ * and \ref DS1302_UNITS to split the value into digits.
+ *
+ * \returns Value in BCD code
+ */
+static inline uint8_t DS1302_snapshot_bcd(const DS1302_snapshot_t *snapshot, uint8_t index)
+{
+    const uint8_t reg = snapshot->regs[index];
+
+    switch(index)
+    {
+        case DS1302_FRAME_SECONDS:
+        case DS1302_FRAME_MINUTES:
+            return (uint8_t)(reg & DS1302_SEC_MIN_MASK);
+        case DS1302_FRAME_HOURS:
+            return (uint8_t)(reg & (((reg & DS1302_FORMAT_MASK) != 0u) ?
+                        DS1302_HOURS_12H_MASK : DS1302_HOURS_24H_MASK));
+        case DS1302_FRAME_DATE:
+            return (uint8_t)(reg & DS1302_DATE_MASK);
+        case DS1302_FRAME_MONTH:
+            return (uint8_t)(reg & DS1302_MONTH_MASK);
+        case DS1302_FRAME_WEEKDAY:
+            return (uint8_t)(reg & DS1302_WEEKDAY_MASK);
+        default:
+            return reg;
+    }
+}
+
+/*!
+ * \brief Splits BCD value of the snapshot register into two digits
+ *
+ * \param snapshot snapshot retrieved with \ref DS1302_get_snapshot
+ * \param index position of the register \ref ds1302_frame_layout
+ * \param digits storage for tens digit followed by units digit
+ */
+static inline void DS1302_snapshot_digits(const DS1302_snapshot_t *snapshot, uint8_t index,
+        uint8_t *digits)
+{
+    const uint8_t bcd = DS1302_snapshot_bcd(snapshot, index);
+
+    digits[0] = DS1302_TENS(bcd);
+    digits[1] = DS1302_UNITS(bcd);
+}
+
+#if DS1302_SEVEN_SEGMENT
+/*!
+ * \brief Gets 7-segment glyph of decimal digit
+ *
+ * \param digit digit to be displayed, 0-9
+ *
+ * \returns Segments to be lit, bit 0 is segment a and bit 6 is segment g
+ */
+uint8_t DS1302_get_glyph(uint8_t digit);
+#endif
+/*@}*/
+
+/*!
+ * \brief Retrieves raw clock burst frame
+ *
+ * \param frame storage for \ref DS1302_FRAME_SIZE registers
+ */
+void DS1302_get_frame(uint8_t *frame);
+
+/*!
+ * \brief Checks raw clock burst frame for invalid BCD codes and values out
+ * of range given by \ref DS1302_get_range_minimum and \ref DS1302_get_range_maximum
+ *
+ * \param frame \ref DS1302_FRAME_SIZE registers retrieved with
+ * \ref DS1302_get_frame
+ *
+ * \note Day of the month is checked against 31 regardless of the month
+ *
+ * \returns Bitmask of invalid data types, bit positions are given by
+ * \ref ds1302_data_types, 0 means frame is valid
+ */
+uint8_t DS1302_check_frame(const uint8_t *frame);
+
+/*!
+ * \brief Converts raw clock burst frame into aggregate
+ *
+ * \param frame \ref DS1302_FRAME_SIZE registers retrieved with
+ * \ref DS1302_get_frame
+ * \param config storage for converted data
+ */
+void DS1302_decode_frame(const uint8_t *frame, DS1302_datetime_t *config);
+
+/*!
+ * \brief Converts aggregate into raw clock burst frame
+ *
+ * \param config aggregate to be converted
+ * \param frame storage for \ref DS1302_FRAME_SIZE registers
+ */
+void DS1302_encode_frame(const DS1302_datetime_t *config, uint8_t *frame);
+
+/*!
+ * \brief Setups clock registers from raw clock burst frame
+ *
+ * \param frame \ref DS1302_FRAME_SIZE registers, control register is ignored
+ */
+void DS1302_set_frame(const uint8_t *frame);
+
 /*!
  * \brief Setups aggregate with all DS1302 data types
  *
  * \param config storage for data to be stored
+ *
+ * \note Aggregate is checked with \ref DS1302_validate first and nothing
+ * is written if it is invalid
+ *
+ * \returns Bitmask of invalid data types as \ref DS1302_validate, 0 on success
  */
-void DS1302_set(const DS1302_datetime_t *config);
+uint8_t DS1302_set(const DS1302_datetime_t *config);
+
+/*!
+ * \brief Converts aggregate into its compact variant
+ *
+ * \param config aggregate to be converted
+ * \param compact storage for converted data
+ */
+static inline void DS1302_to_compact(const DS1302_datetime_t *config, DS1302_compact_t *compact)
+{
+    compact->secs = config->secs;
+    compact->min = config->min;
+    compact->hours = config->hours;
+    compact->weekday = config->weekday;
+    compact->date = config->date;
+    compact->month = config->month;
+    compact->year = config->year;
+    compact->is_12h_mode = config->is_12h_mode;
+    compact->is_pm = config->is_pm;
+}
+
+/*!
+ * \brief Converts compact variant into aggregate
+ *
+ * \param compact compact variant to be converted
+ * \param config storage for converted data
+ */
+static inline void DS1302_from_compact(const DS1302_compact_t *compact, DS1302_datetime_t *config)
+{
+    config->secs = compact->secs;
+    config->min = compact->min;
+    config->hours = compact->hours;
+    config->weekday = compact->weekday;
+    config->date = compact->date;
+    config->month = compact->month;
+    config->year = compact->year;
+    config->is_12h_mode = compact->is_12h_mode;
+    config->is_pm = compact->is_pm;
+}
+
+/*!
+ * \brief Retrieves all DS1302 data types into compact variant
+ *
+ * \param compact storage for the retrieved data
+ */
+void DS1302_get_compact(DS1302_compact_t *compact);
+
+/*!
+ * \brief Setups all DS1302 data types from compact variant
+ *
+ * \param compact data to be stored
+ *
+ * \returns Bitmask of invalid data types as \ref DS1302_validate, 0 on success
+ */
+uint8_t DS1302_set_compact(const DS1302_compact_t *compact);
+
+/*!
+ * \brief Enables/disables driver option
+ *
+ * \param option option to be changed \ref ds1302_options
+ * \param enable true enables option
+ */
+void DS1302_set_option(uint8_t option, bool enable);
+
+/*!
+ * \brief Starts batch of writes
+ *
+ * With \ref DS1302_OPTION_AUTO_WRITE_PROTECTION write protection is disabled
+ * at most once within batch and restored by \ref DS1302_end_batch. Batches
+ * can be nested.
+ */
+void DS1302_begin_batch(void);
+
+/*!
+ * \brief Ends batch of writes started with \ref DS1302_begin_batch
+ */
+void DS1302_end_batch(void);
+
+/*!
+ * \brief Checks hours format
+ *
+ * \note Uses shadow of the hours register if it is known, otherwise reads
+ * the register
+ *
+ * \retval true device runs in 12h mode
+ * \retval false device runs in 24h mode
+ */
+bool DS1302_is_12h_mode(void);
+
+/*!
+ * \brief Switches hours format of the device, rewriting only the hours register
+ *
+ * \param is_12h_mode true switches device into 12h mode
+ *
+ * \note Nothing is transferred if the shadow of the hours register shows
+ * requested format already. Otherwise the hours register is read, as it keeps
+ * running, converted and written back.
+ */
+void DS1302_set_hours_format(bool is_12h_mode);
+
+/*!
+ * \brief Setups trickle charger
+ *
+ * \param setting trickle charger setting \ref ds1302_trickle_charger
+ *
+ * \note Register is written only when setting differs from its shadow
+ */
+void DS1302_set_trickle_charger(uint8_t setting);
+
+/*!
+ * \brief Gets trickle charger setting
+ *
+ * \note Uses shadow of the register if it is known, otherwise reads the register
+ *
+ * \returns Trickle charger setting \ref ds1302_trickle_charger
+ */
+uint8_t DS1302_get_trickle_charger(void);
+
+/*!
+ * \brief Invalidates all register shadows kept by the driver
+ *
+ * \note Has to be called whenever something else than the driver
+ * might have changed the device registers
+ */
+void DS1302_invalidate_cache(void);
+
+/*!
+ * \brief Checks all members of the aggregate in one pass
+ *
+ * \param config aggregate to be checked
+ *
+ * \note Day of the month is checked against length of the month, hours
+ * against range of the hours format
+ *
+ * \returns Bitmask of invalid data types, bit positions are given by
+ * \ref ds1302_data_types, 0 means aggregate is valid
+ */
+uint8_t DS1302_validate(const DS1302_datetime_t *config);
+
+/*!
+ * \brief Gets day of the year
+ *
+ * \param config aggregate
+ *
+ * \returns Day of the year, starting from 1, 0 if month or year is out of
+ * range
+ */
+uint16_t DS1302_day_of_year(const DS1302_datetime_t *config);
+
+/*!
+ * \brief Gets ISO-8601 week of the year
+ *
+ * \param config aggregate
+ *
+ * \note Days at the turn of the year might belong to the last week of
+ * the previous year or to the first week of the next year
+ *
+ * \returns Week of the year 1-53, 0 if month or year is out of range
+ */
+uint8_t DS1302_iso_week(const DS1302_datetime_t *config);
+
+/*!
+ * \brief Gets number of days between dates of two aggregates
+ *
+ * \param from first aggregate
+ * \param to second aggregate
+ *
+ * \returns Number of days, negative if the second date precedes the first one,
+ * 0 if month or year of either aggregate is out of range
+ */
+int32_t DS1302_days_between(const DS1302_datetime_t *from, const DS1302_datetime_t *to);
+
+/*!
+ * \brief Converts hours of the aggregate into 12h format with AM/PM in place
+ *
+ * \param config aggregate, either in 24h or 12h format
+ */
+void DS1302_to_12h_mode(DS1302_datetime_t *config);
+
+/*!
+ * \brief Converts hours of the aggregate into 24h format in place
+ *
+ * \param config aggregate, either in 24h or 12h format
+ */
+void DS1302_to_24h_mode(DS1302_datetime_t *config);
+
+/*!
+ * \brief Computes day of the week
+ *
+ * \param year year
+ * \param month month
+ * \param date day of the month
+ *
+ * \returns Day of the week \ref ds1302_weekdays, 0 if month or year is out
+ * of range
+ */
+uint8_t DS1302_compute_weekday(uint8_t year, uint8_t month, uint8_t date);
+
+/*!
+ * \brief Converts aggregate into seconds since the beginning of the century
+ * \ref DS1302_CENTURY_BASE
+ *
+ * \param config aggregate to be converted, either in 24h or 12h format
+ *
+ * \returns Seconds since the beginning of the century,
+ * \ref DS1302_TIMESTAMP_INVALID if month or year is out of range
+ */
+uint32_t DS1302_to_epoch(const DS1302_datetime_t *config);
+
+/*!
+ * \brief Converts seconds since the beginning of the century
+ * \ref DS1302_CENTURY_BASE into aggregate
+ *
+ * \param epoch seconds since the beginning of the century, up to its end
+ * \param config storage for converted data, its is_12h_mode member selects
+ * hours format of the result
+ *
+ * \note Day of the week is filled according to \ref ds1302_weekdays
+ */
+void DS1302_from_epoch(uint32_t epoch, DS1302_datetime_t *config);
+
+/*!
+ * \brief Converts raw clock burst frame straight into packed timestamp
+ *
+ * \param frame \ref DS1302_FRAME_SIZE registers retrieved with
+ * \ref DS1302_get_frame
+ *
+ * \note Frame is checked with \ref DS1302_check_frame first, day of the week
+ * is not taken into account
+ *
+ * \returns Packed timestamp, \ref DS1302_TIMESTAMP_INVALID if frame is
+ * invalid, e.g. read from erased or unpowered device
+ */
+DS1302_timestamp_t DS1302_pack_frame(const uint8_t *frame);
+
+/*!
+ * \brief Converts aggregate into packed timestamp
+ *
+ * \param config aggregate to be converted
+ *
+ * \returns Packed timestamp
+ */
+static inline DS1302_timestamp_t DS1302_pack(const DS1302_datetime_t *config)
+{
+    return DS1302_to_epoch(config);
+}
+
+/*!
+ * \brief Converts packed timestamp into aggregate
+ *
+ * \param timestamp packed timestamp
+ * \param config storage for converted data, its is_12h_mode member selects
+ * hours format of the result
+ */
+static inline void DS1302_unpack(DS1302_timestamp_t timestamp, DS1302_datetime_t *config)
+{
+    DS1302_from_epoch(timestamp, config);
+}
+
+/*!
+ * \brief Advances raw clock burst frame by one second in BCD domain, so it
+ * stays bit-identical to registers of running DS1302
+ *
+ * \param frame \ref DS1302_FRAME_SIZE registers, e.g. \ref DS1302_snapshot_t regs
+ *
+ * \note Clock halt bit and hours format are preserved, month ends, leap
+ * years, day of the week and year 99 wrap into 00 are handled. Cheap enough
+ * for 1 Hz timer interrupt.
+ */
+void DS1302_tick_frame(uint8_t *frame);
+
+/*!
+ * \brief Adds days to the aggregate in place
+ *
+ * \param config aggregate to be changed
+ * \param days number of days to be added
+ *
+ * \note Year wraps around after 99, so whole centuries are skipped before
+ * walking months
+ */
+void DS1302_add_days(DS1302_datetime_t *config, uint32_t days);
+
+/*!
+ * \brief Adds minutes to the aggregate in place, carrying into hours and days
+ *
+ * \param config aggregate to be changed, either in 24h or 12h format
+ * \param min number of minutes to be added
+ */
+void DS1302_add_minutes(DS1302_datetime_t *config, uint32_t min);
+
+/*!
+ * \brief Adds seconds to the aggregate in place, carrying into minutes,
+ * hours and days
+ *
+ * \param config aggregate to be changed, either in 24h or 12h format
+ * \param secs number of seconds to be added
+ */
+void DS1302_add_seconds(DS1302_datetime_t *config, uint32_t secs);
+
+/*!
+ * \brief Formats time of the aggregate as HH:MM:SS in 24h format
+ *
+ * \param buf buffer of at least \ref DS1302_TIME_STRING_SIZE characters
+ * \param config aggregate, either in 24h or 12h format
+ *
+ * \returns Position of the terminating null in the buffer
+ */
+char *DS1302_format_time(char *buf, const DS1302_datetime_t *config);
+
+/*!
+ * \brief Formats time of the aggregate as HH:MM:SS AM/PM in 12h format
+ *
+ * \param buf buffer of at least \ref DS1302_TIME_12H_STRING_SIZE characters
+ * \param config aggregate, either in 24h or 12h format
+ *
+ * \returns Position of the terminating null in the buffer
+ */
+char *DS1302_format_time_12h(char *buf, const DS1302_datetime_t *config);
+
+/*!
+ * \brief Formats date of the aggregate as DD.MM.YY
+ *
+ * \param buf buffer of at least \ref DS1302_DATE_STRING_SIZE characters
+ * \param config aggregate
+ *
+ * \returns Position of the terminating null in the buffer
+ */
+char *DS1302_format_date(char *buf, const DS1302_datetime_t *config);
+
+/*!
+ * \brief Formats aggregate as ISO-8601 YYYY-MM-DDTHH:MM:SS
+ *
+ * \param buf buffer of at least \ref DS1302_ISO8601_STRING_SIZE characters
+ * \param config aggregate, either in 24h or 12h format
+ *
+ * \returns Position of the terminating null in the buffer
+ */
+char *DS1302_format_iso8601(char *buf, const DS1302_datetime_t *config);
+
+/*!
+ * \brief Formats time kept in raw clock burst frame as HH:MM:SS, straight
+ * from BCD codes
+ *
+ * \param buf buffer of at least \ref DS1302_TIME_STRING_SIZE characters
+ * \param frame \ref DS1302_FRAME_SIZE registers retrieved with
+ * \ref DS1302_get_frame
+ *
+ * \note Hours are formatted in the format device runs in
+ *
+ * \returns Position of the terminating null in the buffer
+ */
+char *DS1302_format_frame_time(char *buf, const uint8_t *frame);
+
+/*!
+ * \brief Formats date kept in raw clock burst frame as DD.MM.YY, straight
+ * from BCD codes
+ *
+ * \param buf buffer of at least \ref DS1302_DATE_STRING_SIZE characters
+ * \param frame \ref DS1302_FRAME_SIZE registers retrieved with
+ * \ref DS1302_get_frame
+ *
+ * \returns Position of the terminating null in the buffer
+ */
+char *DS1302_format_frame_date(char *buf, const uint8_t *frame);
+
+/*!
+ * \brief Formats raw clock burst frame as ISO-8601 YYYY-MM-DDTHH:MM:SS,
+ * straight from BCD codes
+ *
+ * \param buf buffer of at least \ref DS1302_ISO8601_STRING_SIZE characters
+ * \param frame \ref DS1302_FRAME_SIZE registers retrieved with
+ * \ref DS1302_get_frame
+ *
+ * \note Hours are formatted in the format device runs in
+ *
+ * \returns Position of the terminating null in the buffer
+ */
+char *DS1302_format_frame_iso8601(char *buf, const uint8_t *frame);
+
+/*!
+ * \brief Parses ISO-8601 date and time YYYY-MM-DDTHH:MM:SS into raw clock
+ * burst frame
+ *
+ * \param str string to be parsed, T may be replaced with space and
+ * string may end with Z
+ * \param frame storage for \ref DS1302_FRAME_SIZE registers, ready for
+ * \ref DS1302_set_frame, left untouched if string is invalid
+ *
+ * \note Year has to belong to the century \ref DS1302_CENTURY_BASE, day of
+ * the week is computed
+ *
+ * \retval true string is valid
+ * \retval false string is malformed or holds values out of range
+ */
+bool DS1302_parse_iso8601_frame(const char *str, uint8_t *frame);
+
+/*!
+ * \brief Parses ISO-8601 date and time YYYY-MM-DDTHH:MM:SS into aggregate
+ *
+ * \param str string to be parsed, see \ref DS1302_parse_iso8601_frame
+ * \param config storage for parsed data in 24h format, left untouched if
+ * string is invalid
+ *
+ * \retval true string is valid
+ * \retval false string is malformed or holds values out of range
+ */
+bool DS1302_parse_iso8601(const char *str, DS1302_datetime_t *config);
+
+/*!
+ * \brief Parses time HHMMSS into raw clock burst frame
+ *
+ * \param str string to be parsed, may be followed by fraction of the second
+ * given as "." and at least one digit, which is ignored
+ * \param frame clock burst frame, only its time registers are updated
+ *
+ * \retval true string is valid
+ * \retval false string is malformed or holds values out of range
+ */
+bool DS1302_parse_time_frame(const char *str, uint8_t *frame);
+
+/*!
+ * \brief Parses time HHMMSS into aggregate
+ *
+ * \param str string to be parsed, see \ref DS1302_parse_time_frame
+ * \param config aggregate, only its time members are updated, in 24h format
+ *
+ * \retval true string is valid
+ * \retval false string is malformed or holds values out of range
+ */
+bool DS1302_parse_time(const char *str, DS1302_datetime_t *config);
+
+/*!
+ * \brief Parses date DDMMYY into raw clock burst frame
+ *
+ * \param str string to be parsed
+ * \param frame clock burst frame, only its date registers are updated,
+ * including computed day of the week
+ *
+ * \retval true string is valid
+ * \retval false string is malformed or holds values out of range
+ */
+bool DS1302_parse_date_frame(const char *str, uint8_t *frame);
+
+/*!
+ * \brief Parses date DDMMYY into aggregate
+ *
+ * \param str string to be parsed
+ * \param config aggregate, only its date members are updated, including
+ * computed day of the week
+ *
+ * \retval true string is valid
+ * \retval false string is malformed or holds values out of range
+ */
+bool DS1302_parse_date(const char *str, DS1302_datetime_t *config);
 
 /*!
  * \brief Configures DS1302 device
+ *
+ * \note Reads write protection state into driver cache. If oscillator is
+ * found halted the clock is seeded with the build timestamp in single burst,
+ * see \ref DS1302_SEED_BUILD_TIMESTAMP.
  */
 void DS1302_configure(void);
 
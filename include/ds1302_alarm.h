@@ -0,0 +1,173 @@
+/*!
+ * \file
+ * \brief DS1302 alarm scheduler header file
+ * \author Dawid Babula
+ * \email dbabula@adventurous.pl
+ *
+ * \par Copyright (C) Dawid Babula, 2020
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef DS1302_ALARM_H
+#define DS1302_ALARM_H
+
+/*!
+ *
+ * \addtogroup ds1302_alarm
+ * \ingroup ds1302
+ * \brief DS1302 software alarms
+ *
+ * DS1302 has no alarm hardware, so alarms are kept in hierarchical timer
+ * wheel keyed by packed timestamp \ref DS1302_timestamp_t. Each level has
+ * 16 slots, so level n spans 16^(n+1) seconds, alarms further away wait on
+ * overflow list. Advancing time by one second costs constant time regardless
+ * of number of pending alarms, apart from cascading alarms into lower levels.
+ * Alarm nodes are provided by the caller, no dynamic memory is used.
+ *
+ * \code
+ * static DS1302_alarm_t wake_up;
+ *
+ * DS1302_alarm_init(DS1302_pack_frame(frame));
+ * DS1302_alarm_start(&wake_up, DS1302_pack(&config), DS1302_ALARM_DAILY,
+ *         on_wake_up, NULL);
+ *
+ * // every second, e.g. after DS1302_get_frame
+ * DS1302_alarm_sync(DS1302_pack_frame(frame));
+ * \endcode
+ */
+
+/*@{*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "ds1302.h"
+
+#ifndef DS1302_ALARM_LEVELS
+/*!
+ * \brief Number of timer wheel levels, 4 levels span 65536 seconds
+ */
+#define DS1302_ALARM_LEVELS     (4u)
+#endif
+
+/*!
+ *
+ * \addtogroup ds1302_alarm_periods
+ * \ingroup ds1302_alarm
+ * \brief Common repeat periods in seconds
+ */
+/*@{*/
+#define DS1302_ALARM_ONCE       (0UL)
+#define DS1302_ALARM_MINUTELY   (60UL)
+#define DS1302_ALARM_HOURLY     (3600UL)
+#define DS1302_ALARM_DAILY      (86400UL)
+#define DS1302_ALARM_WEEKLY     (604800UL)
+/*@}*/
+
+/*!
+ * \brief Alarm callback
+ *
+ * \param context context given to \ref DS1302_alarm_start
+ */
+typedef void (*DS1302_alarm_callback_t)(void *context);
+
+/*!
+ * \brief Alarm node, owned by the caller and valid until alarm fires or
+ * it is cancelled
+ *
+ * \note Node has to be zero-initialized before first use
+ */
+typedef struct DS1302_alarm
+{
+    struct DS1302_alarm *next; /*!< Next alarm in the slot */
+    struct DS1302_alarm **pprev; /*!< Link pointing to this alarm, NULL when not pending */
+    DS1302_timestamp_t expiry; /*!< Time of the next firing */
+    uint32_t period; /*!< Repeat period in seconds, \ref DS1302_ALARM_ONCE for single shot */
+    DS1302_alarm_callback_t callback; /*!< Function called when alarm fires */
+    void *context; /*!< Argument of the callback */
+} DS1302_alarm_t;
+
+/*!
+ * \brief Initializes scheduler, dropping all pending alarms
+ *
+ * \param now current time
+ */
+void DS1302_alarm_init(DS1302_timestamp_t now);
+
+/*!
+ * \brief Starts alarm, restarting it if already pending
+ *
+ * \param alarm alarm node
+ * \param expiry time of the first firing, e.g. packed with \ref DS1302_pack
+ * \param period repeat period in seconds \ref ds1302_alarm_periods
+ * \param callback function called when alarm fires
+ * \param context argument of the callback
+ *
+ * \note Alarm due already fires with the next advance of time, repeating
+ * alarm is moved to its next occurrence instead
+ */
+void DS1302_alarm_start(DS1302_alarm_t *alarm, DS1302_timestamp_t expiry,
+        uint32_t period, DS1302_alarm_callback_t callback, void *context);
+
+/*!
+ * \brief Cancels alarm, does nothing if alarm is not pending
+ *
+ * \param alarm alarm node
+ */
+void DS1302_alarm_cancel(DS1302_alarm_t *alarm);
+
+/*!
+ * \brief Checks if alarm is pending
+ *
+ * \param alarm alarm node
+ *
+ * \retval true alarm is waiting to be fired
+ * \retval false alarm has fired or it has been cancelled
+ */
+static inline bool DS1302_alarm_is_pending(const DS1302_alarm_t *alarm)
+{
+    return (alarm->pprev != NULL);
+}
+
+/*!
+ * \brief Advances time by one second, firing alarms which are due
+ *
+ * \note Callbacks are called from this function and may start or cancel
+ * alarms. Not reentrant.
+ */
+void DS1302_alarm_tick(void);
+
+/*!
+ * \brief Advances time to the given time, firing alarms which are due
+ *
+ * \param now current time, e.g. packed with \ref DS1302_pack_frame
+ *
+ * \note Short gaps are caught up second by second. After time is set back
+ * or jumps further than timer wheel spans, alarms are rescheduled, overdue
+ * single shot alarms fire with the next advance of time and repeating ones
+ * skip to their next occurrence. \ref DS1302_TIMESTAMP_INVALID, e.g. packed
+ * from frame of unpowered device, is ignored.
+ */
+void DS1302_alarm_sync(DS1302_timestamp_t now);
+
+/*!
+ * \brief Gets time of the scheduler
+ *
+ * \returns Current time of the scheduler
+ */
+DS1302_timestamp_t DS1302_alarm_get_time(void);
+
+/*@}*/
+#endif
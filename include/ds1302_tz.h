@@ -0,0 +1,144 @@
+/*!
+ * \file
+ * \brief DS1302 time zone header file
+ * \author Dawid Babula
+ * \email dbabula@adventurous.pl
+ *
+ * \par Copyright (C) Dawid Babula, 2020
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef DS1302_TZ_H
+#define DS1302_TZ_H
+
+/*!
+ *
+ * \addtogroup ds1302_tz
+ * \ingroup ds1302
+ * \brief DS1302 time zone and daylight saving time rules
+ *
+ * Device is meant to keep UTC, local time is derived only when needed.
+ * Rules follow POSIX TZ "Mm.w.d/time" form, e.g. Central European Time
+ * "CET-1CEST,M3.5.0,M10.5.0/3" is described by
+ *
+ * \code
+ * static const DS1302_tz_rule_t cet =
+ * {
+ *     .std_offset = 60, .dst_offset = 120, .has_dst = true,
+ *     .dst_start = { .month = 3, .week = 5, .weekday = DS1302_SUNDAY, .minute = 120 },
+ *     .dst_end = { .month = 10, .week = 5, .weekday = DS1302_SUNDAY, .minute = 180 },
+ * };
+ * \endcode
+ */
+
+/*@{*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "ds1302.h"
+
+/*!
+ * \brief Transition between standard and daylight saving time
+ */
+typedef struct
+{
+    uint8_t month; /*!< Month */
+    uint8_t week; /*!< Week of the month 1-5, 5 means the last one */
+    uint8_t weekday; /*!< Day of the week \ref ds1302_weekdays */
+    uint16_t minute; /*!< Minute of the day in local time in effect before transition */
+} DS1302_tz_transition_t;
+
+/*!
+ * \brief Time zone rule
+ */
+typedef struct
+{
+    int16_t std_offset; /*!< Standard time offset east of UTC in minutes */
+    int16_t dst_offset; /*!< Daylight saving time offset east of UTC in minutes */
+    DS1302_tz_transition_t dst_start; /*!< Start of daylight saving time */
+    DS1302_tz_transition_t dst_end; /*!< End of daylight saving time */
+    bool has_dst; /*!< Daylight saving time is observed */
+} DS1302_tz_rule_t;
+
+/*!
+ * \brief Time zone state, caches offset until the next transition
+ */
+typedef struct
+{
+    const DS1302_tz_rule_t *rule; /*!< Time zone rule */
+    DS1302_timestamp_t valid_from; /*!< UTC timestamp cached offset is valid from */
+    DS1302_timestamp_t valid_until; /*!< UTC timestamp of the next transition */
+    int16_t offset; /*!< Cached offset east of UTC in minutes */
+    bool is_dst; /*!< Cached offset is daylight saving time offset */
+    bool has_dst; /*!< Rule observes daylight saving time and its transitions are valid */
+} DS1302_tz_t;
+
+/*!
+ * \brief Initializes time zone state
+ *
+ * \param tz time zone state
+ * \param rule time zone rule, has to outlive the state
+ *
+ * \note Rule with transition out of range, e.g. month 0 or week 6, is
+ * reported with ASSERT and only its standard time offset is used
+ */
+void DS1302_tz_init(DS1302_tz_t *tz, const DS1302_tz_rule_t *rule);
+
+/*!
+ * \brief Gets offset of the local time
+ *
+ * \param tz time zone state
+ * \param utc UTC timestamp
+ *
+ * \note Transitions are computed only when timestamp leaves cached interval
+ *
+ * \returns Offset east of UTC in minutes
+ */
+int16_t DS1302_tz_get_offset(DS1302_tz_t *tz, DS1302_timestamp_t utc);
+
+/*!
+ * \brief Converts UTC timestamp into local timestamp
+ *
+ * \param tz time zone state
+ * \param utc UTC timestamp
+ *
+ * \returns Local timestamp
+ */
+DS1302_timestamp_t DS1302_tz_to_local_timestamp(DS1302_tz_t *tz, DS1302_timestamp_t utc);
+
+/*!
+ * \brief Converts UTC aggregate into local aggregate
+ *
+ * \param tz time zone state
+ * \param utc UTC aggregate
+ * \param local storage for local aggregate, its is_12h_mode member selects
+ * hours format of the result
+ */
+void DS1302_tz_to_local(DS1302_tz_t *tz, const DS1302_datetime_t *utc,
+        DS1302_datetime_t *local);
+
+/*!
+ * \brief Checks if daylight saving time is in effect
+ *
+ * \param tz time zone state
+ * \param utc UTC timestamp
+ *
+ * \retval true daylight saving time is in effect
+ * \retval false standard time is in effect
+ */
+bool DS1302_tz_is_dst(DS1302_tz_t *tz, DS1302_timestamp_t utc);
+
+/*@}*/
+#endif
@@ -66,6 +66,37 @@
 
 #define READ_WP                 (0x8F)
 #define WRITE_WP                (0x8E)
+
+#define READ_TRICKLE            (0x91)
+#define WRITE_TRICKLE           (0x90)
+
+#define READ_CLOCK_BURST        (0xBF)
+#define WRITE_CLOCK_BURST       (0xBE)
+/*@}*/
+
+/*!
+ *
+ * \addtogroup ds1302_frame
+ * \ingroup ds1302
+ * \brief DS1302 clock burst frame layout
+ */
+/*@{*/
+#define CLOCK_REGISTERS         (7u)
+#define REGISTER_STEP           (2u)
+
+#define DIFF_BURST_THRESHOLD    (1u)
+/*@}*/
+
+/*!
+ *
+ * \addtogroup ds1302_shadows
+ * \ingroup ds1302
+ * \brief DS1302 register shadows validity flags
+ */
+/*@{*/
+#define CLOCK_SHADOW            (0x01u)
+#define CONTROL_SHADOW          (0x02u)
+#define TRICKLE_SHADOW          (0x04u)
 /*@}*/
 
 /*!
@@ -77,7 +108,6 @@
 /*@{*/
 #define WRITE_PROTECTION_MASK   (0x80u)
 #define HOURS_UNIT_MASK         (0x1Fu)
-#define WEEKDAY_UNIT_MASK       (0x07u)
 #define OTHER_UNIT_MASK         (0x0Fu)
 
 #define SEC_MIN_TENS_MASK       (0x70u)
@@ -86,66 +116,441 @@
 #define DATE_TENS_MASK          (0x30u)
 #define MONTH_TENS_MASK         (0x10u)
 #define YEAR_TENS_MASK          (0xF0u)
-#define AM_PM_MASK              (0x20U)
+#define CLOCK_HALT_MASK         (0x80U)
 
 #define TENS_SHIFT              (4u)
 #define FORMAT_SHIFT            (7U)
 #define AM_PM_SHIFT             (5U)
 
-#define UNIT_FACTOR             (1u)
 #define TENS_FACTOR             (10u)
+#define UNITS_MASK              (0x0Fu)
+#define TENS_RECIPROCAL         (103u)
+#define TENS_RECIPROCAL_SHIFT   (10u)
 
 #define CLK_DELAY               (2u)
 #define MSB_SHIFT               (7u)
+
+#define FIELDS                  (DS1302_AM_PM + 1u)
+#define FIELDS_ALL              ((1u << (DS1302_YEAR + 1u)) - 1u)
+
+#define SECONDS_PER_MINUTE      (60u)
+#define SECONDS_PER_HOUR        (3600u)
+#define SECONDS_PER_DAY         (86400UL)
+#define HOURS_PER_HALF_DAY      (12u)
+#define DAYS_PER_WEEK           (7u)
+#define DAYS_PER_YEAR           (365u)
+#define DAYS_PER_4_YEARS        (1461u)
+#define DAYS_BEFORE_MARCH       (59u)
+#define MINUTES_PER_HOUR        (60u)
+#define ISO_WEEK_OFFSET         (10u)
+#define WEEKS_PER_LONG_YEAR     (53u)
+#define WEEKS_PER_YEAR          (52u)
+#define HOURS_PER_DAY           (24u)
+#define YEAR_MAXIMUM            (99u)
+#define DIGIT_PAIRS_SIZE        (200u)
+#define TWO_DIGITS_MAXIMUM      (99u)
+#define INVALID_DIGIT           ('-')
+#define DECIMAL_DIGITS          (10u)
+#define BCD_FIRST               (0x01u)
+#define BCD_NOON                (0x12u)
+#define BCD_DECEMBER            (0x12u)
+#define BCD_LAST_MINUTE         (0x59u)
+#define BCD_LAST_HOUR_24H       (0x23u)
+#define BCD_LAST_HOUR_12H       (0x11u)
+#define BCD_LAST_YEAR           (0x99u)
+#define CENTURY_DIGITS          ((DS1302_CENTURY_BASE / 100u) % 100u)
+#define DIGIT_MAXIMUM           (9u)
+#define LEAP_YEAR_BYTES         (13u)
+/*@}*/
+
+/*!
+ *
+ * \addtogroup ds1302_century
+ * \ingroup ds1302
+ * \brief DS1302 century related constants derived from \ref DS1302_CENTURY_BASE
+ */
+/*@{*/
+#define IS_LEAP_YEAR(year)      ((((year) % 4u) == 0u) && \
+                                ((((year) % 100u) != 0u) || (((year) % 400u) == 0u)))
+#define LEAP_BIT(year)          (IS_LEAP_YEAR(DS1302_CENTURY_BASE + (year)) ? \
+                                (1u << ((year) % 8u)) : 0u)
+#define LEAP_BYTE(index)        (LEAP_BIT(8u*(index)) | LEAP_BIT(8u*(index) + 1u) | \
+                                LEAP_BIT(8u*(index) + 2u) | LEAP_BIT(8u*(index) + 3u) | \
+                                LEAP_BIT(8u*(index) + 4u) | LEAP_BIT(8u*(index) + 5u) | \
+                                LEAP_BIT(8u*(index) + 6u) | LEAP_BIT(8u*(index) + 7u))
+
+/*! Day missing from the 4-year cycle, when first year of the century is not leap */
+#define CENTURY_LEAP_DAY        (IS_LEAP_YEAR(DS1302_CENTURY_BASE) ? 0u : 1u)
+/*! Number of days after which calendar of the century repeats */
+#define CENTURY_DAYS            (100u*DAYS_PER_YEAR + 25u - CENTURY_LEAP_DAY)
+/*! Day of the week of the first day of the century, 0 is Sunday */
+#define CENTURY_WEEKDAY         ((1u + 5u*((DS1302_CENTURY_BASE - 1u) % 4u) + \
+                                4u*((DS1302_CENTURY_BASE - 1u) % 100u) + \
+                                6u*((DS1302_CENTURY_BASE - 1u) % 400u)) % 7u)
+#define EPOCH_WEEKDAY_OFFSET    ((CENTURY_WEEKDAY + DS1302_SATURDAY) % DAYS_PER_WEEK)
+
+/*@}*/
+
+#if !defined(__AVR__) && defined(__BYTE_ORDER__) && \
+    (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define SWAR_DECODE
+#endif
+
+#if defined(SWAR_DECODE)
+/*!
+ *
+ * \addtogroup ds1302_lanes
+ * \ingroup ds1302
+ * \brief DS1302 clock burst frame masks, when frame is processed as 64-bit word
+ */
+/*@{*/
+#define LANE(index, mask)       ((uint64_t)(mask) << ((index) * CHAR_BIT))
+
+#define FRAME_MASK              (LANE(DS1302_FRAME_SECONDS, DS1302_SEC_MIN_MASK) | \
+                                LANE(DS1302_FRAME_MINUTES, DS1302_SEC_MIN_MASK) | \
+                                LANE(DS1302_FRAME_DATE, DS1302_DATE_MASK) | \
+                                LANE(DS1302_FRAME_MONTH, DS1302_MONTH_MASK) | \
+                                LANE(DS1302_FRAME_WEEKDAY, DS1302_WEEKDAY_MASK) | \
+                                LANE(DS1302_FRAME_YEAR, DS1302_YEAR_MASK))
+#define LANES_UNITS_MASK        (0x0F0F0F0F0F0F0F0Full)
+#define LANES_DIGIT_CARRY       (0x0606060606060606ull)
+#define LANES_NIBBLE_CARRY      (0x1010101010101010ull)
+#define LANES_HIGH_BIT          (0x8080808080808080ull)
+#define LANES_LOW_BIT           (0x0101010101010101ull)
+
+#define RANGED_LANES            (LANE(DS1302_FRAME_SECONDS, 0x7Fu) | \
+                                LANE(DS1302_FRAME_MINUTES, 0x7Fu) | \
+                                LANE(DS1302_FRAME_HOURS, 0x7Fu) | \
+                                LANE(DS1302_FRAME_DATE, 0x7Fu) | \
+                                LANE(DS1302_FRAME_MONTH, 0x7Fu) | \
+                                LANE(DS1302_FRAME_WEEKDAY, 0x7Fu))
+#define LANES_MAX_24H           (LANE(DS1302_FRAME_SECONDS, 0x59u) | \
+                                LANE(DS1302_FRAME_MINUTES, 0x59u) | \
+                                LANE(DS1302_FRAME_HOURS, 0x23u) | \
+                                LANE(DS1302_FRAME_DATE, 0x31u) | \
+                                LANE(DS1302_FRAME_MONTH, 0x12u) | \
+                                LANE(DS1302_FRAME_WEEKDAY, 0x07u))
+#define LANES_MAX_12H           ((LANES_MAX_24H & ~LANE(DS1302_FRAME_HOURS, 0xFFu)) | \
+                                LANE(DS1302_FRAME_HOURS, 0x12u))
+#define LANES_MIN_24H           (LANE(DS1302_FRAME_DATE, 0x01u) | \
+                                LANE(DS1302_FRAME_MONTH, 0x01u) | \
+                                LANE(DS1302_FRAME_WEEKDAY, 0x01u))
+#define LANES_MIN_12H           (LANES_MIN_24H | LANE(DS1302_FRAME_HOURS, 0x01u))
 /*@}*/
+#endif
 
 /*!
- * \brief DS1302 data type range
+ * \brief DS1302 data type layout within the register
  */
 typedef struct
 {
+    uint8_t reg; /*!< Register index within clock burst frame */
+    uint8_t unit_mask; /*!< Mask of the unit part */
+    uint8_t tens_mask; /*!< Mask of the tens part */
+    uint8_t shift; /*!< Shift of the unit part */
     uint8_t min; /*!< Minimum */
     uint8_t max; /*!< Maximum */
-} DS1302_range_t;
-
-static const DS1302_range_t ranges[8] PROGMEM =
-{
-    [DS1302_SECONDS]    = { .min = 0U, .max = 59U },
-    [DS1302_MINUTES]    = { .min = 0U, .max = 59U },
-    [DS1302_HOURS_24H]  = { .min = 0U, .max = 23U },
-    [DS1302_HOURS_12H]  = { .min = 1U, .max = 12U },
-    [DS1302_WEEKDAY]    = { .min = 1U, .max = 7U  },
-    [DS1302_DATE]       = { .min = 1U, .max = 31U },
-    [DS1302_MONTH]      = { .min = 1U, .max = 12U },
-    [DS1302_YEAR]       = { .min = 0U, .max = 99U },
+} DS1302_field_t;
+
+static uint8_t options;
+static uint8_t batch_depth;
+static bool is_protection_requested;
+static uint8_t shadow_valid;
+static uint8_t clock_shadow[CLOCK_REGISTERS];
+static uint8_t control_shadow;
+static uint8_t trickle_shadow;
+
+#if !defined(SWAR_DECODE)
+static const uint8_t lane_masks[CLOCK_REGISTERS] PROGMEM =
+{
+    [DS1302_FRAME_SECONDS]     = DS1302_SEC_MIN_MASK,
+    [DS1302_FRAME_MINUTES]     = DS1302_SEC_MIN_MASK,
+    [DS1302_FRAME_HOURS]       = DS1302_HOURS_24H_MASK,
+    [DS1302_FRAME_DATE]        = DS1302_DATE_MASK,
+    [DS1302_FRAME_MONTH]       = DS1302_MONTH_MASK,
+    [DS1302_FRAME_WEEKDAY]     = DS1302_WEEKDAY_MASK,
+    [DS1302_FRAME_YEAR]        = DS1302_YEAR_MASK,
+};
+
+static const uint8_t lane_types[CLOCK_REGISTERS] PROGMEM =
+{
+    [DS1302_FRAME_SECONDS]     = DS1302_SECONDS,
+    [DS1302_FRAME_MINUTES]     = DS1302_MINUTES,
+    [DS1302_FRAME_HOURS]       = DS1302_HOURS_24H,
+    [DS1302_FRAME_DATE]        = DS1302_DATE,
+    [DS1302_FRAME_MONTH]       = DS1302_MONTH,
+    [DS1302_FRAME_WEEKDAY]     = DS1302_WEEKDAY,
+    [DS1302_FRAME_YEAR]        = DS1302_YEAR,
+};
+#endif
+
+static const uint8_t leap_years[LEAP_YEAR_BYTES] PROGMEM =
+{
+    LEAP_BYTE(0u), LEAP_BYTE(1u), LEAP_BYTE(2u), LEAP_BYTE(3u), LEAP_BYTE(4u),
+    LEAP_BYTE(5u), LEAP_BYTE(6u), LEAP_BYTE(7u), LEAP_BYTE(8u), LEAP_BYTE(9u),
+    LEAP_BYTE(10u), LEAP_BYTE(11u), LEAP_BYTE(12u),
+};
+
+static const uint8_t days_in_month[DECEMBER] PROGMEM =
+{
+    DAYS_31, DAYS_28, DAYS_31, DAYS_30, DAYS_31, DAYS_30,
+    DAYS_31, DAYS_31, DAYS_30, DAYS_31, DAYS_30, DAYS_31,
+};
+
+static const char digit_pairs[DIGIT_PAIRS_SIZE] PROGMEM =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+#if DS1302_SEED_BUILD_TIMESTAMP
+static const uint8_t build_frame[DS1302_FRAME_SIZE] PROGMEM = DS1302_BUILD_FRAME;
+#endif
+
+#if DS1302_SEVEN_SEGMENT
+static const uint8_t glyphs[DECIMAL_DIGITS] PROGMEM =
+{
+    0x3FU, 0x06U, 0x5BU, 0x4FU, 0x66U, 0x6DU, 0x7DU, 0x07U, 0x7FU, 0x6FU
+};
+#endif
+
+static const uint16_t days_before_month[DECEMBER] PROGMEM =
+{
+    0U, 31U, 59U, 90U, 120U, 151U, 181U, 212U, 243U, 273U, 304U, 334U,
+};
+
+static const DS1302_field_t fields[FIELDS] PROGMEM =
+{
+    [DS1302_SECONDS]    = { DS1302_FRAME_SECONDS, OTHER_UNIT_MASK, SEC_MIN_TENS_MASK, 0U, 0U, 59U },
+    [DS1302_MINUTES]    = { DS1302_FRAME_MINUTES, OTHER_UNIT_MASK, SEC_MIN_TENS_MASK, 0U, 0U, 59U },
+    [DS1302_HOURS_24H]  = { DS1302_FRAME_HOURS, OTHER_UNIT_MASK, HOURS_24H_TENS_MASK, 0U, 0U, 23U },
+    [DS1302_HOURS_12H]  = { DS1302_FRAME_HOURS, OTHER_UNIT_MASK, HOURS_12H_TENS_MASK, 0U, 1U, 12U },
+    [DS1302_WEEKDAY]    = { DS1302_FRAME_WEEKDAY, DS1302_WEEKDAY_MASK, 0U, 0U, 1U, 7U },
+    [DS1302_DATE]       = { DS1302_FRAME_DATE, OTHER_UNIT_MASK, DATE_TENS_MASK, 0U, 1U, 31U },
+    [DS1302_MONTH]      = { DS1302_FRAME_MONTH, OTHER_UNIT_MASK, MONTH_TENS_MASK, 0U, 1U, 12U },
+    [DS1302_YEAR]       = { DS1302_FRAME_YEAR, OTHER_UNIT_MASK, YEAR_TENS_MASK, 0U, 0U, 99U },
+    [DS1302_FORMAT]     = { DS1302_FRAME_HOURS, DS1302_FORMAT_MASK, 0U, FORMAT_SHIFT, 0U, 1U },
+    [DS1302_AM_PM]      = { DS1302_FRAME_HOURS, DS1302_AM_PM_MASK, 0U, AM_PM_SHIFT, 0U, 1U },
 };
 
 /*!
  * \brief Checks if year is a leap year
  *
- * \param year year to be check for leapness
+ * \param year year of the century \ref DS1302_CENTURY_BASE to be check
+ * for leapness
  *
  * \retval true year is leap year
  * \retval false year is normal year
  */
 static inline bool is_leap_year(uint8_t year)
 {
-    if((year % 4U) != 0U)
+    return ((pgm_read_byte(&leap_years[year >> 3U]) >> (year & 7U)) & 1U) != 0U;
+}
+
+/*!
+ * \brief Checks value against range of the data type
+ *
+ * \param type data type \ref ds1302_data_types
+ * \param val value to be checked
+ *
+ * \returns Bit of the data type if value is out of range, 0 otherwise
+ */
+static inline uint8_t check_range(uint8_t type, uint8_t val)
+{
+    const bool is_invalid = (val < pgm_read_byte(&fields[type].min)) ||
+        (val > pgm_read_byte(&fields[type].max));
+
+    return (uint8_t)((is_invalid ? 1U : 0U) << type);
+}
+
+/*!
+ * \brief Gets number of days from the beginning of the century up to
+ * the beginning of the year
+ *
+ * \param year year
+ *
+ * \returns Number of days
+ */
+static inline uint16_t days_before_year(uint8_t year)
+{
+    const uint16_t ret = (uint16_t)(DAYS_PER_YEAR * year) + ((year + 3U) >> 2U);
+
+    return (year > 0U) ? (ret - CENTURY_LEAP_DAY) : ret;
+}
+
+/*!
+ * \brief Checks if year and month can be looked up in calendar tables
+ *
+ * \param year year
+ * \param month month
+ *
+ * \retval true year and month are within range
+ * \retval false year or month is out of range
+ */
+static inline bool is_calendar_valid(uint8_t year, uint8_t month)
+{
+    return (month >= JANUARY) && (month <= DECEMBER) && (year <= YEAR_MAXIMUM);
+}
+
+/*!
+ * \brief Gets number of days from the beginning of the century
+ *
+ * \param year year
+ * \param month month, checked with \ref is_calendar_valid by the caller
+ * \param date day of the month
+ *
+ * \returns Number of days
+ */
+static uint16_t days_from_date(uint8_t year, uint8_t month, uint8_t date)
+{
+    uint16_t ret = days_before_year(year) +
+        pgm_read_word(&days_before_month[month - 1U]) + date - 1U;
+
+    if((month > FEBRUARY) && is_leap_year(year))
     {
-        return false;
+        ret++;
     }
 
-    if((year % CENTURY) != 0U)
+    return ret;
+}
+
+/*!
+ * \brief Gets day of the week from number of days from the beginning
+ * of the century
+ *
+ * \param days number of days
+ *
+ * \returns Day of the week \ref ds1302_weekdays
+ */
+static inline uint8_t weekday_from_days(uint16_t days)
+{
+    return (uint8_t)((days + EPOCH_WEEKDAY_OFFSET) % DAYS_PER_WEEK) + 1U;
+}
+
+/*!
+ * \brief Converts number of days from the beginning of the century
+ * into date
+ *
+ * \param days number of days
+ * \param config storage for year, month, day of the month and day of the week
+ *
+ * \note Months from March onwards are found with (5 * day + 2) / 153
+ * formula, which follows lengths of the months from March up to January
+ */
+static void date_from_days(uint16_t days, DS1302_datetime_t *config)
+{
+    const uint8_t year = (uint8_t)(((uint32_t)(days + CENTURY_LEAP_DAY) * 4U) /
+            DAYS_PER_4_YEARS);
+    const uint16_t day = days - days_before_year(year);
+    const uint16_t march = DAYS_BEFORE_MARCH + (is_leap_year(year) ? 1U : 0U);
+
+    config->year = year;
+    config->weekday = weekday_from_days(days);
+
+    if(day >= march)
     {
-        return true;
+        const uint16_t since_march = day - march;
+        const uint8_t month = (uint8_t)((5U * since_march + 2U) / 153U);
+
+        config->month = month + MARCH;
+        config->date = (uint8_t)(since_march - (153U * month + 2U) / 5U) + 1U;
+    }
+    else if(day >= DAYS_31)
+    {
+        config->month = FEBRUARY;
+        config->date = (uint8_t)(day - DAYS_31) + 1U;
+    }
+    else
+    {
+        config->month = JANUARY;
+        config->date = (uint8_t)day + 1U;
     }
+}
 
-    if((year % (4U*CENTURY)) != 0U)
+/*!
+ * \brief Converts hours into 24h format
+ *
+ * \param hours hours in format given by is_12h_mode
+ * \param is_12h_mode true if hours are in 12h format
+ * \param is_pm true if hours are PM hours, in case of 12h format
+ *
+ * \returns Hours in 24h format
+ */
+static inline uint8_t to_hours_24h(uint8_t hours, bool is_12h_mode, bool is_pm)
+{
+    if(!is_12h_mode)
     {
-        return false;
+        return hours;
     }
 
-    return true;
+    hours = (hours == HOURS_PER_HALF_DAY) ? 0U : hours;
+
+    return is_pm ? (hours + HOURS_PER_HALF_DAY) : hours;
+}
+
+/*!
+ * \brief Gets number of seconds from the beginning of the century
+ *
+ * \param days number of days from the beginning of the century
+ * \param hours hours in 24h format
+ * \param min minutes
+ * \param secs seconds
+ *
+ * \returns Number of seconds
+ */
+static inline uint32_t seconds_from_days(uint16_t days, uint8_t hours, uint8_t min,
+        uint8_t secs)
+{
+    return (uint32_t)days * SECONDS_PER_DAY + (uint32_t)hours * SECONDS_PER_HOUR +
+        (uint16_t)min * SECONDS_PER_MINUTE + secs;
+}
+
+/*!
+ * \brief Gets number of ISO weeks in the year
+ *
+ * \param first day of the week of the first day of the year \ref ds1302_weekdays
+ * \param is_leap true if year is leap year
+ *
+ * \returns Number of ISO weeks
+ */
+static inline uint8_t weeks_in_year(uint8_t first, bool is_leap)
+{
+    const bool is_long = (first == DS1302_THURSDAY) ||
+        (is_leap && (first == DS1302_WEDNESDAY));
+
+    return is_long ? WEEKS_PER_LONG_YEAR : WEEKS_PER_YEAR;
+}
+
+/*!
+ * \brief Gets hours of the aggregate in 24h format
+ *
+ * \param config aggregate
+ *
+ * \returns Hours in 24h format
+ */
+static inline uint8_t get_hours_24h(const DS1302_datetime_t *config)
+{
+    return to_hours_24h(config->hours, config->is_12h_mode, config->is_pm);
+}
+
+/*!
+ * \brief Setups hours of the aggregate, keeping its hours format
+ *
+ * \param config aggregate
+ * \param hours hours in 24h format
+ */
+static inline void set_hours_24h(DS1302_datetime_t *config, uint8_t hours)
+{
+    if(!config->is_12h_mode)
+    {
+        config->hours = hours;
+        return;
+    }
+
+    config->is_pm = (hours >= HOURS_PER_HALF_DAY);
+    hours = config->is_pm ? (hours - HOURS_PER_HALF_DAY) : hours;
+    config->hours = (hours == 0U) ? HOURS_PER_HALF_DAY : hours;
 }
 
 /*!
@@ -156,22 +561,28 @@ static inline bool is_leap_year(uint8_t year)
  * \retval true type is valid
  * \retval false type is invalid
  */
-static bool is_get_range_type_valid(uint8_t type)
+static inline bool is_get_range_type_valid(uint8_t type)
 {
-    switch(type)
-    {
-        case DS1302_SECONDS:
-        case DS1302_MINUTES:
-        case DS1302_HOURS_24H:
-        case DS1302_HOURS_12H:
-        case DS1302_WEEKDAY:
-        case DS1302_DATE:
-        case DS1302_MONTH:
-        case DS1302_YEAR:
-            return true;
-        default:
-            return false;
-    }
+    return (type <= DS1302_YEAR);
+}
+
+/*!
+ * \brief Converts binary value into BCD code without division
+ *
+ * \param val value to be converted, has to be lower than 100
+ *
+ * \note Division by \ref TENS_FACTOR is replaced with multiplication by its
+ * scaled reciprocal, which is exact for values lower than 179. AVR has no
+ * hardware divider, so it saves two calls of division routine per value.
+ *
+ * \returns Value in BCD code
+ */
+static inline uint8_t bin_to_bcd(uint8_t val)
+{
+    const uint8_t tens = (uint8_t)(((uint16_t)val * TENS_RECIPROCAL) >> TENS_RECIPROCAL_SHIFT);
+    const uint8_t units = val - (uint8_t)((tens << 3U) + (tens << 1U));
+
+    return (uint8_t)((tens << TENS_SHIFT) | units);
 }
 
 /*!
@@ -185,40 +596,18 @@ static bool is_get_range_type_valid(uint8_t type)
  */
 static uint8_t get_value_to_store(uint8_t entry, uint8_t val)
 {
-    switch(entry)
-    {
-        case DS1302_SECONDS:
-        case DS1302_MINUTES:
-            return ((((val / TENS_FACTOR) << TENS_SHIFT) & SEC_MIN_TENS_MASK) |
-                    (val % TENS_FACTOR));
-        case DS1302_HOURS_24H:
-            return (((val / TENS_FACTOR) << TENS_SHIFT) & HOURS_24H_TENS_MASK) |
-                    (val % TENS_FACTOR);
-        case DS1302_HOURS_12H:
-            return (((val / TENS_FACTOR) << TENS_SHIFT) & HOURS_12H_TENS_MASK) |
-                    (val % TENS_FACTOR);
-        case DS1302_AM_PM:
-            return (uint8_t)(val << AM_PM_SHIFT);
-        case DS1302_FORMAT:
-            return (uint8_t)(val << FORMAT_SHIFT);
-        case DS1302_WEEKDAY:
-            return (val & WEEKDAY_UNIT_MASK);
-        case DS1302_DATE:
-            return (((val / TENS_FACTOR) << TENS_SHIFT) & DATE_TENS_MASK) |
-                (val % TENS_FACTOR);
-        case DS1302_MONTH:
-            return (((val / TENS_FACTOR) << TENS_SHIFT) & MONTH_TENS_MASK) |
-                (val % TENS_FACTOR);
-        case DS1302_YEAR:
-            return (((val / TENS_FACTOR) << TENS_SHIFT) & YEAR_TENS_MASK) |
-                (val % TENS_FACTOR);
-        default:
-            ASSERT(false);
-            break;
-
+    if(entry >= FIELDS)
+    {
+        ASSERT(false);
+        return 0U;
     }
 
-    return 0U;
+    const uint8_t unit_mask = pgm_read_byte(&fields[entry].unit_mask);
+    const uint8_t tens_mask = pgm_read_byte(&fields[entry].tens_mask);
+    const uint8_t shift = pgm_read_byte(&fields[entry].shift);
+    const uint8_t bcd = bin_to_bcd(val);
+
+    return (bcd & tens_mask) | (((bcd & UNITS_MASK) << shift) & unit_mask);
 }
 
 /*!
@@ -231,39 +620,18 @@ static uint8_t get_value_to_store(uint8_t entry, uint8_t val)
  */
 static uint8_t get_value_to_load(uint8_t entry, uint8_t val)
 {
-    switch(entry)
-    {
-        case DS1302_SECONDS:
-        case DS1302_MINUTES:
-            return (val & OTHER_UNIT_MASK)*UNIT_FACTOR +
-                ((val & SEC_MIN_TENS_MASK) >> TENS_SHIFT) * TENS_FACTOR;
-        case DS1302_FORMAT:
-            return (val >> FORMAT_SHIFT);
-        case DS1302_AM_PM:
-            return ((val & AM_PM_MASK) >> AM_PM_SHIFT);
-        case DS1302_HOURS_24H:
-            return (val & OTHER_UNIT_MASK)*UNIT_FACTOR +
-                ((val & HOURS_24H_TENS_MASK) >> TENS_SHIFT) * TENS_FACTOR;
-        case DS1302_HOURS_12H:
-            return (val & OTHER_UNIT_MASK)*UNIT_FACTOR +
-                ((val & HOURS_12H_TENS_MASK) >> TENS_SHIFT) * TENS_FACTOR;
-        case DS1302_WEEKDAY:
-            return (val & WEEKDAY_UNIT_MASK)*UNIT_FACTOR;
-        case DS1302_DATE:
-            return (val & OTHER_UNIT_MASK)*UNIT_FACTOR +
-                ((val & DATE_TENS_MASK) >> TENS_SHIFT) * TENS_FACTOR;
-        case DS1302_MONTH:
-            return (val & OTHER_UNIT_MASK)*UNIT_FACTOR +
-                ((val & MONTH_TENS_MASK) >> TENS_SHIFT) * TENS_FACTOR;
-        case DS1302_YEAR:
-            return (val & OTHER_UNIT_MASK)*UNIT_FACTOR +
-                ((val & YEAR_TENS_MASK) >> TENS_SHIFT) * TENS_FACTOR;
-        default:
-            ASSERT(false);
-            break;
+    if(entry >= FIELDS)
+    {
+        ASSERT(false);
+        return 0U;
     }
 
-    return 0;
+    const uint8_t unit_mask = pgm_read_byte(&fields[entry].unit_mask);
+    const uint8_t tens_mask = pgm_read_byte(&fields[entry].tens_mask);
+    const uint8_t shift = pgm_read_byte(&fields[entry].shift);
+
+    return ((val & unit_mask) >> shift) +
+        ((val & tens_mask) >> TENS_SHIFT) * TENS_FACTOR;
 }
 
 /*!
@@ -377,149 +745,1856 @@ static uint8_t read(uint8_t reg)
     return ret;
 }
 
-void DS1302_get(DS1302_datetime_t *config)
+/*!
+ * \brief Checks if register shadow holds known content
+ *
+ * \param shadow shadow validity flag \ref ds1302_shadows
+ *
+ * \retval true shadow is valid
+ * \retval false shadow has to be read from the device
+ */
+static inline bool is_cached(uint8_t shadow)
 {
-    if(config != NULL)
-    {
-        config->year = get_value_to_load(DS1302_YEAR, read(READ_YEAR));
-        config->month = get_value_to_load(DS1302_MONTH, read(READ_MONTH));
-        config->date = get_value_to_load(DS1302_DATE, read(READ_DATE));
-        config->weekday = get_value_to_load(DS1302_WEEKDAY, read(READ_WEEKDAY));
-
-        uint8_t value = read(READ_HOURS);
-        config->is_12h_mode = get_value_to_load(DS1302_FORMAT, value);
-
-        if(config->is_12h_mode)
-        {
-            config->is_pm = get_value_to_load(DS1302_AM_PM, value);
-            config->hours = get_value_to_load(DS1302_HOURS_12H, value);
-        }
-        else
-        {
-            config->hours = get_value_to_load(DS1302_HOURS_24H, value);
-        }
-
-        config->min = get_value_to_load(DS1302_MINUTES, read(READ_MINUTES));
-        config->secs = get_value_to_load(DS1302_SECONDS, read(READ_SECONDS));
-    }
+    return ((shadow_valid & shadow) != 0U);
 }
 
-void DS1302_set(const DS1302_datetime_t *config)
+/*!
+ * \brief Reads single register through its shadow
+ *
+ * \param reg register to be read from
+ * \param data register shadow
+ * \param shadow shadow validity flag \ref ds1302_shadows
+ *
+ * \returns Register content
+ */
+static uint8_t read_cached(uint8_t reg, uint8_t *data, uint8_t shadow)
 {
-    if(config != NULL)
+    if(!is_cached(shadow))
     {
-        write(WRITE_YEAR, get_value_to_store(DS1302_YEAR, config->year));
-        write(WRITE_MONTH, get_value_to_store(DS1302_MONTH, config->month));
-        write(WRITE_DATE, get_value_to_store(DS1302_DATE, config->date));
-        write(WRITE_WEEKDAY, get_value_to_store(DS1302_WEEKDAY, config->weekday));
-
-        uint8_t value = get_value_to_store(DS1302_FORMAT, config->is_12h_mode);
-
-        if(config->is_12h_mode)
-        {
-            value |= get_value_to_store(DS1302_AM_PM, config->is_pm);
-            value |= get_value_to_store(DS1302_HOURS_12H, config->hours);
-        }
-        else
-        {
-            value |= get_value_to_store(DS1302_HOURS_24H, config->hours);
-        }
-
-        write(WRITE_HOURS, value);
-
-        write(WRITE_MINUTES, get_value_to_store(DS1302_MINUTES, config->min));
-        write(WRITE_SECONDS, get_value_to_store(DS1302_SECONDS, config->secs));
+        *data = read(reg);
+        shadow_valid |= shadow;
     }
+
+    return *data;
 }
 
-uint8_t DS1302_get_seconds(void)
+/*!
+ * \brief Checks if automatic write protection bracketing is enabled
+ *
+ * \retval true bracketing is enabled
+ * \retval false bracketing is disabled
+ */
+static inline bool is_auto_protection(void)
 {
-    uint8_t ret = read(READ_SECONDS);
-
-    ret = get_value_to_load(DS1302_SECONDS, ret);
-
-    return ret;
+    return ((options & DS1302_OPTION_AUTO_WRITE_PROTECTION) != 0U);
 }
 
-uint8_t DS1302_get_minutes(void)
+/*!
+ * \brief Checks if DS1302 accepts writes, which is known for sure only when
+ * write protection is bracketed automatically or seen disabled
+ *
+ * \retval true writes are accepted
+ * \retval false writes may be ignored
+ */
+static inline bool is_write_accepted(void)
 {
-    uint8_t ret = read(READ_MINUTES);
-
-    ret = get_value_to_load(DS1302_MINUTES, ret);
-
-    return ret;
+    return is_auto_protection() ||
+        (is_cached(CONTROL_SHADOW) && ((control_shadow & WRITE_PROTECTION_MASK) == 0U));
 }
 
-uint8_t DS1302_get_hours(bool is_12h_mode)
+/*!
+ * \brief Updates clock register shadow after write, invalidating it when
+ * the write may have been ignored
+ *
+ * \param index position of the register in the frame
+ * \param value value written
+ */
+static void update_clock_shadow(uint8_t index, uint8_t value)
 {
-    uint8_t ret = read(READ_HOURS);
-
-    ret = get_value_to_load(is_12h_mode ? DS1302_HOURS_12H : DS1302_HOURS_24H, ret);
+    if(!is_write_accepted())
+    {
+        shadow_valid &= (uint8_t)~CLOCK_SHADOW;
+        return;
+    }
 
-    return ret;
+    clock_shadow[index] = value;
 }
 
-uint8_t DS1302_get_range_minimum(uint8_t type)
+/*!
+ * \brief Writes single register through its shadow, unless shadow
+ * already holds the value
+ *
+ * \param reg register to be written to
+ * \param data register shadow
+ * \param shadow shadow validity flag \ref ds1302_shadows
+ * \param value value to be written
+ */
+static void write_cached(uint8_t reg, uint8_t *data, uint8_t shadow, uint8_t value)
 {
-    if(!is_get_range_type_valid(type))
+    if(is_cached(shadow) && (*data == value))
     {
-        ASSERT(false);
+        return;
     }
 
-    return pgm_read_byte(&ranges[type].min);
-}
+    write(reg, value);
 
-uint8_t DS1302_get_range_maximum(uint8_t type)
-{
-    if(!is_get_range_type_valid(type) || (type == DS1302_DATE))
+    /* control register is writable regardless of write protection */
+    if((reg != WRITE_WP) && !is_write_accepted())
     {
-        ASSERT(false);
+        shadow_valid &= (uint8_t)~shadow;
+        return;
     }
 
-    return pgm_read_byte(&ranges[type].max);
+    *data = value;
+    shadow_valid |= shadow;
 }
 
-uint8_t DS1302_get_date_range_maximum(uint8_t year, uint8_t month)
+/*!
+ * \brief Writes write protection bit, unless cached state already matches
+ *
+ * \param val write protection setting, true enables write protection
+ */
+static void write_protection(bool val)
 {
-    const bool is_leap = is_leap_year(year);
+    write_cached(WRITE_WP, &control_shadow, CONTROL_SHADOW,
+            val ? WRITE_PROTECTION_MASK : 0U);
+}
 
-    switch(month)
+/*!
+ * \brief Disables write protection ahead of writes in automatic bracketing mode
+ */
+static void unlock(void)
+{
+    if(is_auto_protection())
     {
-        case JANUARY:
-        case MARCH:
-        case MAY:
-        case JULY:
-        case AUGUST:
-        case OCTOBER:
-        case DECEMBER:
-            return DAYS_31;
-        case APRIL:
-        case JUNE:
-        case SEPTEMBER:
-        case NOVEMBER:
-            return DAYS_30;
-        case FEBRUARY:
-            return (is_leap ? DAYS_29 : DAYS_28);
-        default:
-            ASSERT(false);
-            return 0U;
+        write_protection(false);
     }
 }
 
-void DS1302_set_write_protection(bool val)
+/*!
+ * \brief Restores requested write protection after writes in automatic
+ * bracketing mode, unless batch is in progress
+ */
+static void relock(void)
 {
-    if(val)
-    {
-        write(WRITE_WP, WRITE_PROTECTION_MASK);
-    }
-    else
+    if(is_auto_protection() && (batch_depth == 0U))
     {
-        write(WRITE_WP, 0U);
+        write_protection(is_protection_requested);
     }
 }
 
-
-void DS1302_configure(void)
+/*!
+ * \brief Writes clock registers in burst mode
+ *
+ * \param regs \ref CLOCK_REGISTERS registers to be written
+ *
+ * \note DS1302 latches clock burst only once control register has been
+ * transferred as well, which is used to restore write protection at once in
+ * automatic bracketing mode. Otherwise control register is written back
+ * unchanged and its shadow is left alone, as the write may be ignored.
+ */
+static void write_burst(const uint8_t *regs)
 {
-    /* is going to be implemented later */
+    uint8_t control = is_protection_requested ? WRITE_PROTECTION_MASK : 0U;
+
+    if(is_auto_protection())
+    {
+        control = (batch_depth == 0U) ? control : 0U;
+    }
+    else if(is_cached(CONTROL_SHADOW))
+    {
+        control = control_shadow;
+    }
+
+    start();
+    write_byte(WRITE_CLOCK_BURST);
+
+    for(uint8_t i = 0U; i < CLOCK_REGISTERS; i++)
+    {
+        write_byte(regs[i]);
+    }
+
+    write_byte(control);
+    stop();
+
+    if(is_auto_protection())
+    {
+        control_shadow = control;
+        shadow_valid |= CONTROL_SHADOW;
+    }
+}
+
+/*!
+ * \brief Reads clock registers in burst mode
+ *
+ * \param data storage for read registers
+ * \param size number of registers to be read, starting from seconds
+ */
+static void read_burst(uint8_t *data, uint8_t size)
+{
+    start();
+    write_byte(READ_CLOCK_BURST);
+
+    for(uint8_t i = 0U; i < size; i++)
+    {
+        data[i] = read_byte();
+    }
+
+    stop();
+}
+
+/*!
+ * \brief Converts aggregate into clock registers content
+ *
+ * \param config aggregate to be converted
+ * \param regs storage for \ref CLOCK_REGISTERS registers
+ */
+static void encode_datetime(const DS1302_datetime_t *config, uint8_t *regs)
+{
+    regs[DS1302_FRAME_YEAR] = get_value_to_store(DS1302_YEAR, config->year);
+    regs[DS1302_FRAME_MONTH] = get_value_to_store(DS1302_MONTH, config->month);
+    regs[DS1302_FRAME_DATE] = get_value_to_store(DS1302_DATE, config->date);
+    regs[DS1302_FRAME_WEEKDAY] = get_value_to_store(DS1302_WEEKDAY, config->weekday);
+
+    uint8_t value = get_value_to_store(DS1302_FORMAT, config->is_12h_mode);
+
+    if(config->is_12h_mode)
+    {
+        value |= get_value_to_store(DS1302_AM_PM, config->is_pm);
+        value |= get_value_to_store(DS1302_HOURS_12H, config->hours);
+    }
+    else
+    {
+        value |= get_value_to_store(DS1302_HOURS_24H, config->hours);
+    }
+
+    regs[DS1302_FRAME_HOURS] = value;
+    regs[DS1302_FRAME_MINUTES] = get_value_to_store(DS1302_MINUTES, config->min);
+    regs[DS1302_FRAME_SECONDS] = get_value_to_store(DS1302_SECONDS, config->secs);
+}
+
+#if !defined(SWAR_DECODE)
+/*!
+ * \brief Decodes BCD lanes of clock burst frame one register at a time
+ *
+ * \param frame clock burst frame
+ * \param lanes storage for \ref CLOCK_REGISTERS binary values
+ *
+ * \note Tuned for 8-bit core, multiplication by \ref TENS_FACTOR is replaced
+ * with shifts and masks are taken from single table
+ */
+static void decode_lanes(const uint8_t *frame, uint8_t *lanes)
+{
+    for(uint8_t i = 0U; i < CLOCK_REGISTERS; i++)
+    {
+        lanes[i] = DS1302_bcd_to_bin(frame[i] & pgm_read_byte(&lane_masks[i]));
+    }
+
+    if((frame[DS1302_FRAME_HOURS] & DS1302_FORMAT_MASK) != 0U)
+    {
+        lanes[DS1302_FRAME_HOURS] = DS1302_bcd_to_bin(frame[DS1302_FRAME_HOURS] &
+                DS1302_HOURS_12H_MASK);
+    }
+}
+#else
+/*!
+ * \brief Decodes BCD lanes of clock burst frame all at once
+ *
+ * \param frame clock burst frame
+ * \param lanes storage for \ref DS1302_FRAME_SIZE binary values
+ *
+ * \note Frame is processed as single 64-bit word, each byte lane holds
+ * at most 165 after decoding, so no carry crosses lanes
+ */
+static void decode_lanes(const uint8_t *frame, uint8_t *lanes)
+{
+    uint64_t word = 0U;
+
+    memcpy(&word, frame, DS1302_FRAME_SIZE);
+
+    if((frame[DS1302_FRAME_HOURS] & DS1302_FORMAT_MASK) != 0U)
+    {
+        word &= FRAME_MASK | LANE(DS1302_FRAME_HOURS, DS1302_HOURS_12H_MASK);
+    }
+    else
+    {
+        word &= FRAME_MASK | LANE(DS1302_FRAME_HOURS, DS1302_HOURS_24H_MASK);
+    }
+
+    const uint64_t tens = (word >> TENS_SHIFT) & LANES_UNITS_MASK;
+
+    word = (word & LANES_UNITS_MASK) + (tens << 3U) + (tens << 1U);
+
+    memcpy(lanes, &word, DS1302_FRAME_SIZE);
+}
+#endif
+
+#if !defined(SWAR_DECODE)
+/*!
+ * \brief Checks clock burst frame one register at a time
+ *
+ * \param frame clock burst frame
+ *
+ * \returns Bitmask of invalid data types, bit positions are given by
+ * \ref ds1302_data_types
+ */
+static uint8_t check_frame(const uint8_t *frame)
+{
+    const bool is_12h_mode = ((frame[DS1302_FRAME_HOURS] & DS1302_FORMAT_MASK) != 0U);
+    uint8_t ret = 0U;
+
+    for(uint8_t i = 0U; i < CLOCK_REGISTERS; i++)
+    {
+        uint8_t type = pgm_read_byte(&lane_types[i]);
+
+        if(is_12h_mode && (type == DS1302_HOURS_24H))
+        {
+            type = DS1302_HOURS_12H;
+        }
+
+        const uint8_t value = frame[i] & (pgm_read_byte(&fields[type].unit_mask) |
+                pgm_read_byte(&fields[type].tens_mask));
+        const bool is_invalid = ((value & UNITS_MASK) > 9U) ||
+            ((value >> TENS_SHIFT) > 9U) ||
+            (value < bin_to_bcd(pgm_read_byte(&fields[type].min))) ||
+            (value > bin_to_bcd(pgm_read_byte(&fields[type].max)));
+
+        if(is_invalid)
+        {
+            ret |= (uint8_t)(1U << type);
+        }
+    }
+
+    return ret;
+}
+#else
+/*!
+ * \brief Checks clock burst frame all at once
+ *
+ * \param frame clock burst frame
+ *
+ * \note Nibbles above 9 are found by adding 6 and testing carry into the next
+ * nibble. BCD codes are ordered as binary values, so ranges are checked on
+ * raw codes by adding complement of the limit and testing carry into bit 7.
+ * Year lane holds full range and is excluded from that test, which keeps all
+ * tested lanes below 0x80, so no carry crosses lanes.
+ *
+ * \returns Bitmask of invalid data types, bit positions are given by
+ * \ref ds1302_data_types
+ */
+static uint8_t check_frame(const uint8_t *frame)
+{
+    const bool is_12h_mode = ((frame[DS1302_FRAME_HOURS] & DS1302_FORMAT_MASK) != 0U);
+    uint64_t word = 0U;
+
+    memcpy(&word, frame, DS1302_FRAME_SIZE);
+
+    word &= FRAME_MASK | (is_12h_mode ? LANE(DS1302_FRAME_HOURS, DS1302_HOURS_12H_MASK) :
+            LANE(DS1302_FRAME_HOURS, DS1302_HOURS_24H_MASK));
+
+    const uint64_t units = (word & LANES_UNITS_MASK) + LANES_DIGIT_CARRY;
+    const uint64_t tens = ((word >> TENS_SHIFT) & LANES_UNITS_MASK) + LANES_DIGIT_CARRY;
+    const uint64_t digits = (units | tens) & LANES_NIBBLE_CARRY;
+
+    const uint64_t ranged = word & RANGED_LANES;
+    const uint64_t over = ranged + (RANGED_LANES -
+            (is_12h_mode ? LANES_MAX_12H : LANES_MAX_24H));
+    const uint64_t under = ~(ranged + (LANES_HIGH_BIT -
+            (is_12h_mode ? LANES_MIN_12H : LANES_MIN_24H)));
+    const uint64_t limits = (over | under) & LANES_HIGH_BIT;
+
+    /* gather low bit of each lane into single byte */
+    uint64_t lanes = ((digits >> TENS_SHIFT) | (limits >> MSB_SHIFT)) & LANES_LOW_BIT;
+    lanes |= lanes >> 7U;
+    lanes |= lanes >> 14U;
+    lanes |= lanes >> 28U;
+
+    const uint8_t ret = (uint8_t)lanes;
+
+    /* reorder lanes from device order into data types order */
+    return (ret & ((1U << DS1302_SECONDS) | (1U << DS1302_MINUTES))) |
+        (uint8_t)((ret & (1U << DS1302_FRAME_HOURS)) << (is_12h_mode ? 1U : 0U)) |
+        (uint8_t)((ret & (1U << DS1302_FRAME_DATE)) << (DS1302_DATE - DS1302_FRAME_DATE)) |
+        (uint8_t)((ret & (1U << DS1302_FRAME_MONTH)) << (DS1302_MONTH - DS1302_FRAME_MONTH)) |
+        (uint8_t)((ret & (1U << DS1302_FRAME_WEEKDAY)) >> (DS1302_FRAME_WEEKDAY - DS1302_WEEKDAY)) |
+        (uint8_t)((ret & (1U << DS1302_FRAME_YEAR)) << (DS1302_YEAR - DS1302_FRAME_YEAR));
+}
+#endif
+
+/*!
+ * \brief Converts clock burst frame into aggregate
+ *
+ * \param frame clock burst frame to be converted
+ * \param config storage for converted data
+ */
+static void decode_frame(const uint8_t *frame, DS1302_datetime_t *config)
+{
+    uint8_t lanes[DS1302_FRAME_SIZE];
+
+    decode_lanes(frame, lanes);
+
+    config->year = lanes[DS1302_FRAME_YEAR];
+    config->month = lanes[DS1302_FRAME_MONTH];
+    config->date = lanes[DS1302_FRAME_DATE];
+    config->weekday = lanes[DS1302_FRAME_WEEKDAY];
+    config->hours = lanes[DS1302_FRAME_HOURS];
+    config->min = lanes[DS1302_FRAME_MINUTES];
+    config->secs = lanes[DS1302_FRAME_SECONDS];
+
+    config->is_12h_mode = ((frame[DS1302_FRAME_HOURS] & DS1302_FORMAT_MASK) != 0U);
+
+    config->is_pm = config->is_12h_mode && ((frame[DS1302_FRAME_HOURS] & DS1302_AM_PM_MASK) != 0U);
+}
+
+/*!
+ * \brief Checks if hours register holds the last hour of the day
+ *
+ * \param hours raw hours register
+ *
+ * \retval true hours register holds 23 or 11 PM
+ * \retval false any other hour
+ */
+static inline bool is_last_hour(uint8_t hours)
+{
+    const uint8_t last = ((hours & DS1302_FORMAT_MASK) != 0U) ?
+        (DS1302_FORMAT_MASK | DS1302_AM_PM_MASK | BCD_LAST_HOUR_12H) : BCD_LAST_HOUR_24H;
+
+    return ((hours & (DS1302_FORMAT_MASK | DS1302_HOURS_24H_MASK)) == last);
+}
+
+/*!
+ * \brief Writes time registers and only these calendar registers, which
+ * differ from the shadow
+ *
+ * \param regs \ref CLOCK_REGISTERS registers to be written
+ *
+ * \note Calendar registers are compared against the shadow without reading
+ * the device, so single burst is used when the shadow is unknown or has been
+ * taken in the last hour of the day, as the date may have rolled over since.
+ * Burst is also used when more calendar registers differ, as it is shorter
+ * then.
+ */
+static void write_diff(const uint8_t *regs)
+{
+    const bool is_burst = !is_cached(CLOCK_SHADOW) ||
+        is_last_hour(clock_shadow[DS1302_FRAME_HOURS]);
+    uint8_t diff = 0U;
+
+    for(uint8_t i = DS1302_FRAME_DATE; !is_burst && (i < CLOCK_REGISTERS); i++)
+    {
+        if(regs[i] != clock_shadow[i])
+        {
+            diff++;
+        }
+    }
+
+    unlock();
+
+    if(is_burst || (diff > DIFF_BURST_THRESHOLD))
+    {
+        write_burst(regs);
+        return;
+    }
+
+    for(uint8_t i = 0U; i < CLOCK_REGISTERS; i++)
+    {
+        if((i < DS1302_FRAME_DATE) || (regs[i] != clock_shadow[i]))
+        {
+            write(WRITE_SECONDS + i*REGISTER_STEP, regs[i]);
+        }
+    }
+}
+
+/*!
+ * \brief Stores clock registers, either all at once or only these, which
+ * differ from the shadow, depending on \ref DS1302_OPTION_DIFF_WRITES
+ *
+ * \param regs \ref CLOCK_REGISTERS registers to be written
+ */
+static void store_registers(const uint8_t *regs)
+{
+    if((options & DS1302_OPTION_DIFF_WRITES) != 0U)
+    {
+        write_diff(regs);
+    }
+    else
+    {
+        unlock();
+        write_burst(regs);
+    }
+
+    relock();
+
+    if(!is_write_accepted())
+    {
+        shadow_valid &= (uint8_t)~CLOCK_SHADOW;
+        return;
+    }
+
+    memcpy(clock_shadow, regs, CLOCK_REGISTERS);
+    shadow_valid |= CLOCK_SHADOW;
+}
+
+void DS1302_get(DS1302_datetime_t *config)
+{
+    if(config != NULL)
+    {
+        uint8_t frame[DS1302_FRAME_SIZE];
+
+        DS1302_get_frame(frame);
+        decode_frame(frame, config);
+    }
+}
+
+void DS1302_get_frame(uint8_t *frame)
+{
+    if(frame != NULL)
+    {
+        read_burst(frame, DS1302_FRAME_SIZE);
+
+        memcpy(clock_shadow, frame, CLOCK_REGISTERS);
+        control_shadow = frame[DS1302_FRAME_CONTROL];
+        shadow_valid |= CLOCK_SHADOW | CONTROL_SHADOW;
+    }
+}
+
+uint8_t DS1302_check_frame(const uint8_t *frame)
+{
+    if(frame == NULL)
+    {
+        ASSERT(false);
+        return 0U;
+    }
+
+    return check_frame(frame);
+}
+
+void DS1302_decode_frame(const uint8_t *frame, DS1302_datetime_t *config)
+{
+    if((frame != NULL) && (config != NULL))
+    {
+        decode_frame(frame, config);
+    }
+}
+
+uint8_t DS1302_set(const DS1302_datetime_t *config)
+{
+    uint8_t ret = DS1302_validate(config);
+
+    if((options & DS1302_OPTION_AUTO_WEEKDAY) != 0U)
+    {
+        ret &= (uint8_t)~(1U << DS1302_WEEKDAY);
+    }
+
+    if((config != NULL) && (ret == 0U))
+    {
+        uint8_t regs[CLOCK_REGISTERS];
+
+        encode_datetime(config, regs);
+
+        if((options & DS1302_OPTION_AUTO_WEEKDAY) != 0U)
+        {
+            regs[DS1302_FRAME_WEEKDAY] = get_value_to_store(DS1302_WEEKDAY,
+                    DS1302_compute_weekday(config->year, config->month, config->date));
+        }
+
+        store_registers(regs);
+    }
+
+    return ret;
+}
+
+void DS1302_get_snapshot(DS1302_snapshot_t *snapshot)
+{
+    if(snapshot != NULL)
+    {
+        DS1302_get_frame(snapshot->regs);
+    }
+}
+
+#if DS1302_SEVEN_SEGMENT
+uint8_t DS1302_get_glyph(uint8_t digit)
+{
+    if(digit >= DECIMAL_DIGITS)
+    {
+        ASSERT(false);
+        return 0U;
+    }
+
+    return pgm_read_byte(&glyphs[digit]);
+}
+#endif
+
+void DS1302_get_compact(DS1302_compact_t *compact)
+{
+    if(compact != NULL)
+    {
+        DS1302_datetime_t config;
+
+        DS1302_get(&config);
+        DS1302_to_compact(&config, compact);
+    }
+}
+
+uint8_t DS1302_set_compact(const DS1302_compact_t *compact)
+{
+    if(compact == NULL)
+    {
+        return FIELDS_ALL;
+    }
+
+    DS1302_datetime_t config;
+
+    DS1302_from_compact(compact, &config);
+
+    return DS1302_set(&config);
+}
+
+void DS1302_set_frame(const uint8_t *frame)
+{
+    if(frame != NULL)
+    {
+        store_registers(frame);
+    }
+}
+
+void DS1302_encode_frame(const DS1302_datetime_t *config, uint8_t *frame)
+{
+    if((config != NULL) && (frame != NULL))
+    {
+        encode_datetime(config, frame);
+        frame[DS1302_FRAME_CONTROL] = 0U;
+    }
+}
+
+void DS1302_set_option(uint8_t option, bool enable)
+{
+    if(enable)
+    {
+        options |= option;
+    }
+    else
+    {
+        options &= (uint8_t)~option;
+    }
+}
+
+void DS1302_begin_batch(void)
+{
+    batch_depth++;
+}
+
+void DS1302_end_batch(void)
+{
+    if(batch_depth == 0U)
+    {
+        ASSERT(false);
+        return;
+    }
+
+    batch_depth--;
+    relock();
+}
+
+uint8_t DS1302_load(uint8_t type)
+{
+    if(type >= FIELDS)
+    {
+        ASSERT(false);
+        return 0U;
+    }
+
+    const uint8_t index = pgm_read_byte(&fields[type].reg);
+    const uint8_t reg = read(READ_SECONDS + index*REGISTER_STEP);
+
+    if(is_cached(CLOCK_SHADOW))
+    {
+        clock_shadow[index] = reg;
+    }
+
+    return get_value_to_load(type, reg);
+}
+
+void DS1302_store(uint8_t type, uint8_t val)
+{
+    if((type >= FIELDS) ||
+        (val < pgm_read_byte(&fields[type].min)) ||
+        (val > pgm_read_byte(&fields[type].max)))
+    {
+        ASSERT(false);
+        return;
+    }
+
+    if(type == DS1302_FORMAT)
+    {
+        DS1302_set_hours_format(val != 0U);
+        return;
+    }
+
+    const uint8_t index = pgm_read_byte(&fields[type].reg);
+    uint8_t reg = get_value_to_store(type, val);
+
+    if((type == DS1302_HOURS_12H) || (type == DS1302_AM_PM))
+    {
+        const uint8_t hours = read(READ_HOURS);
+
+        if((hours & DS1302_FORMAT_MASK) != 0U)
+        {
+            reg |= hours & (uint8_t)~pgm_read_byte(&fields[type].unit_mask) &
+                (uint8_t)~pgm_read_byte(&fields[type].tens_mask);
+        }
+        else if(type == DS1302_HOURS_12H)
+        {
+            /* in 24h format AM/PM bit is tens digit, half of the day is kept instead */
+            const bool is_pm =
+                (get_value_to_load(DS1302_HOURS_24H, hours) >= HOURS_PER_HALF_DAY);
+
+            reg |= DS1302_FORMAT_MASK | get_value_to_store(DS1302_AM_PM, is_pm);
+        }
+        else
+        {
+            const uint8_t half = get_value_to_load(DS1302_HOURS_24H, hours) % HOURS_PER_HALF_DAY;
+
+            reg = get_value_to_store(DS1302_HOURS_24H,
+                    (val != 0U) ? (half + HOURS_PER_HALF_DAY) : half);
+        }
+    }
+
+    unlock();
+    write(WRITE_SECONDS + index*REGISTER_STEP, reg);
+    update_clock_shadow(index, reg);
+    relock();
+}
+
+uint8_t DS1302_get_range_minimum(uint8_t type)
+{
+    if(!is_get_range_type_valid(type))
+    {
+        ASSERT(false);
+    }
+
+    return pgm_read_byte(&fields[type].min);
+}
+
+uint8_t DS1302_get_range_maximum(uint8_t type)
+{
+    if(!is_get_range_type_valid(type) || (type == DS1302_DATE))
+    {
+        ASSERT(false);
+    }
+
+    return pgm_read_byte(&fields[type].max);
+}
+
+uint8_t DS1302_get_date_range_maximum(uint8_t year, uint8_t month)
+{
+    if(!is_calendar_valid(year, month))
+    {
+        ASSERT(false);
+        return 0U;
+    }
+
+    return pgm_read_byte(&days_in_month[month - 1U]) +
+        (uint8_t)((month == FEBRUARY) & is_leap_year(year));
+}
+
+uint8_t DS1302_validate(const DS1302_datetime_t *config)
+{
+    if(config == NULL)
+    {
+        return FIELDS_ALL;
+    }
+
+    uint8_t ret = check_range(DS1302_SECONDS, config->secs) |
+        check_range(DS1302_MINUTES, config->min) |
+        check_range(config->is_12h_mode ? DS1302_HOURS_12H : DS1302_HOURS_24H,
+                config->hours) |
+        check_range(DS1302_WEEKDAY, config->weekday) |
+        check_range(DS1302_DATE, config->date) |
+        check_range(DS1302_MONTH, config->month) |
+        check_range(DS1302_YEAR, config->year);
+
+    if((ret & ((1U << DS1302_DATE) | (1U << DS1302_MONTH) | (1U << DS1302_YEAR))) == 0U)
+    {
+        if(config->date > DS1302_get_date_range_maximum(config->year, config->month))
+        {
+            ret |= (1U << DS1302_DATE);
+        }
+    }
+
+    return ret;
+}
+
+uint16_t DS1302_day_of_year(const DS1302_datetime_t *config)
+{
+    if((config == NULL) || !is_calendar_valid(config->year, config->month))
+    {
+        ASSERT(false);
+        return 0U;
+    }
+
+    return days_from_date(config->year, config->month, config->date) -
+        days_before_year(config->year) + 1U;
+}
+
+uint8_t DS1302_iso_week(const DS1302_datetime_t *config)
+{
+    if((config == NULL) || !is_calendar_valid(config->year, config->month))
+    {
+        ASSERT(false);
+        return 0U;
+    }
+
+    const uint16_t first_day = days_before_year(config->year);
+    const uint16_t days = days_from_date(config->year, config->month, config->date);
+    const uint8_t first = weekday_from_days(first_day);
+    const uint16_t week = (days - first_day + 1U + ISO_WEEK_OFFSET - weekday_from_days(days)) /
+        DAYS_PER_WEEK;
+
+    if(week == 0U)
+    {
+        /* belongs to the last week of the previous year */
+        const bool is_leap = (config->year > 0U) ? is_leap_year(config->year - 1U) :
+            IS_LEAP_YEAR(DS1302_CENTURY_BASE - 1u);
+        const uint8_t previous = (uint8_t)((first - 1U + DAYS_PER_WEEK*WEEKS_PER_LONG_YEAR -
+                    DAYS_PER_YEAR - (is_leap ? 1U : 0U)) % DAYS_PER_WEEK) + 1U;
+
+        return weeks_in_year(previous, is_leap);
+    }
+
+    if(week > weeks_in_year(first, is_leap_year(config->year)))
+    {
+        /* belongs to the first week of the next year */
+        return 1U;
+    }
+
+    return (uint8_t)week;
+}
+
+int32_t DS1302_days_between(const DS1302_datetime_t *from, const DS1302_datetime_t *to)
+{
+    if((from == NULL) || (to == NULL) || !is_calendar_valid(from->year, from->month) ||
+            !is_calendar_valid(to->year, to->month))
+    {
+        ASSERT(false);
+        return 0;
+    }
+
+    return (int32_t)days_from_date(to->year, to->month, to->date) -
+        (int32_t)days_from_date(from->year, from->month, from->date);
+}
+
+void DS1302_to_12h_mode(DS1302_datetime_t *config)
+{
+    if(config == NULL)
+    {
+        ASSERT(false);
+        return;
+    }
+
+    const uint8_t hours = get_hours_24h(config);
+
+    config->is_12h_mode = true;
+    set_hours_24h(config, hours);
+}
+
+void DS1302_to_24h_mode(DS1302_datetime_t *config)
+{
+    if(config == NULL)
+    {
+        ASSERT(false);
+        return;
+    }
+
+    config->hours = get_hours_24h(config);
+    config->is_12h_mode = false;
+    config->is_pm = false;
+}
+
+uint8_t DS1302_compute_weekday(uint8_t year, uint8_t month, uint8_t date)
+{
+    if(!is_calendar_valid(year, month))
+    {
+        ASSERT(false);
+        return 0U;
+    }
+
+    return weekday_from_days(days_from_date(year, month, date));
+}
+
+uint32_t DS1302_to_epoch(const DS1302_datetime_t *config)
+{
+    if((config == NULL) || !is_calendar_valid(config->year, config->month))
+    {
+        ASSERT(false);
+        return DS1302_TIMESTAMP_INVALID;
+    }
+
+    const uint16_t days = days_from_date(config->year, config->month, config->date);
+
+    return seconds_from_days(days, get_hours_24h(config), config->min, config->secs);
+}
+
+DS1302_timestamp_t DS1302_pack_frame(const uint8_t *frame)
+{
+    if(frame == NULL)
+    {
+        ASSERT(false);
+        return DS1302_TIMESTAMP_INVALID;
+    }
+
+    if((check_frame(frame) & (uint8_t)~(1U << DS1302_WEEKDAY)) != 0U)
+    {
+        ASSERT(false);
+        return DS1302_TIMESTAMP_INVALID;
+    }
+
+    uint8_t lanes[DS1302_FRAME_SIZE];
+
+    decode_lanes(frame, lanes);
+
+    const uint8_t hours = to_hours_24h(lanes[DS1302_FRAME_HOURS],
+            (frame[DS1302_FRAME_HOURS] & DS1302_FORMAT_MASK) != 0U,
+            (frame[DS1302_FRAME_HOURS] & DS1302_AM_PM_MASK) != 0U);
+    const uint16_t days = days_from_date(lanes[DS1302_FRAME_YEAR], lanes[DS1302_FRAME_MONTH],
+            lanes[DS1302_FRAME_DATE]);
+
+    return seconds_from_days(days, hours, lanes[DS1302_FRAME_MINUTES], lanes[DS1302_FRAME_SECONDS]);
+}
+
+void DS1302_from_epoch(uint32_t epoch, DS1302_datetime_t *config)
+{
+    if(config == NULL)
+    {
+        ASSERT(false);
+        return;
+    }
+
+    const uint16_t days = (uint16_t)(epoch / SECONDS_PER_DAY);
+    uint32_t secs = epoch - (uint32_t)days * SECONDS_PER_DAY;
+    const uint8_t hours = (uint8_t)(secs / SECONDS_PER_HOUR);
+
+    secs -= (uint32_t)hours * SECONDS_PER_HOUR;
+    config->min = (uint8_t)(secs / SECONDS_PER_MINUTE);
+    config->secs = (uint8_t)(secs - config->min * SECONDS_PER_MINUTE);
+    set_hours_24h(config, hours);
+    date_from_days(days, config);
+}
+
+void DS1302_add_days(DS1302_datetime_t *config, uint32_t days)
+{
+    if(config == NULL)
+    {
+        ASSERT(false);
+        return;
+    }
+
+    config->weekday = (uint8_t)((config->weekday - 1U + days % DAYS_PER_WEEK) %
+            DAYS_PER_WEEK) + 1U;
+    days %= CENTURY_DAYS;
+
+    while(days > 0U)
+    {
+        const uint8_t left = DS1302_get_date_range_maximum(config->year, config->month) -
+            config->date;
+
+        if(days <= left)
+        {
+            config->date += (uint8_t)days;
+            break;
+        }
+
+        days -= left + 1U;
+        config->date = 1U;
+
+        if(config->month < DECEMBER)
+        {
+            config->month++;
+        }
+        else
+        {
+            config->month = JANUARY;
+            config->year = (config->year < DS1302_get_range_maximum(DS1302_YEAR)) ?
+                (config->year + 1U) : 0U;
+        }
+    }
+}
+
+void DS1302_add_minutes(DS1302_datetime_t *config, uint32_t min)
+{
+    if(config == NULL)
+    {
+        ASSERT(false);
+        return;
+    }
+
+    uint32_t hours = min / MINUTES_PER_HOUR;
+
+    min = min - hours * MINUTES_PER_HOUR + config->min;
+
+    if(min >= MINUTES_PER_HOUR)
+    {
+        min -= MINUTES_PER_HOUR;
+        hours++;
+    }
+
+    config->min = (uint8_t)min;
+
+    if(hours == 0U)
+    {
+        return;
+    }
+
+    hours += get_hours_24h(config);
+
+    const uint32_t days = hours / HOURS_PER_DAY;
+
+    set_hours_24h(config, (uint8_t)(hours - days * HOURS_PER_DAY));
+
+    if(days > 0U)
+    {
+        DS1302_add_days(config, days);
+    }
+}
+
+void DS1302_add_seconds(DS1302_datetime_t *config, uint32_t secs)
+{
+    if(config == NULL)
+    {
+        ASSERT(false);
+        return;
+    }
+
+    if(secs < SECONDS_PER_MINUTE)
+    {
+        const uint8_t sum = config->secs + (uint8_t)secs;
+
+        if(sum < SECONDS_PER_MINUTE)
+        {
+            config->secs = sum;
+            return;
+        }
+    }
+
+    uint32_t min = secs / SECONDS_PER_MINUTE;
+
+    secs = secs - min * SECONDS_PER_MINUTE + config->secs;
+
+    if(secs >= SECONDS_PER_MINUTE)
+    {
+        secs -= SECONDS_PER_MINUTE;
+        min++;
+    }
+
+    config->secs = (uint8_t)secs;
+    DS1302_add_minutes(config, min);
+}
+
+/*!
+ * \brief Increments value in BCD code by one, carrying units into tens
+ *
+ * \param bcd value in BCD code to be incremented
+ *
+ * \returns Incremented value in BCD code
+ */
+static inline uint8_t bcd_increment(uint8_t bcd)
+{
+    if((bcd & UNITS_MASK) == DIGIT_MAXIMUM)
+    {
+        return (uint8_t)((bcd & (uint8_t)~UNITS_MASK) + (1U << TENS_SHIFT));
+    }
+
+    return bcd + 1U;
+}
+
+/*!
+ * \brief Increments hours register by one hour in the format it holds
+ *
+ * \param frame clock burst frame to be changed
+ *
+ * \retval true day has rolled over
+ * \retval false day is the same
+ */
+static bool tick_hours(uint8_t *frame)
+{
+    const uint8_t reg = frame[DS1302_FRAME_HOURS];
+
+    if((reg & DS1302_FORMAT_MASK) == 0U)
+    {
+        if((reg & DS1302_HOURS_24H_MASK) == BCD_LAST_HOUR_24H)
+        {
+            frame[DS1302_FRAME_HOURS] = 0U;
+            return true;
+        }
+
+        frame[DS1302_FRAME_HOURS] = bcd_increment(reg);
+        return false;
+    }
+
+    const uint8_t hours = reg & DS1302_HOURS_12H_MASK;
+
+    if(hours == BCD_LAST_HOUR_12H)
+    {
+        frame[DS1302_FRAME_HOURS] = BCD_NOON | DS1302_FORMAT_MASK |
+            ((reg & DS1302_AM_PM_MASK) ^ DS1302_AM_PM_MASK);
+        return ((reg & DS1302_AM_PM_MASK) != 0U);
+    }
+
+    frame[DS1302_FRAME_HOURS] = (hours == BCD_NOON) ?
+        (uint8_t)((reg & (uint8_t)~DS1302_HOURS_12H_MASK) | 1U) : bcd_increment(reg);
+    return false;
+}
+
+/*!
+ * \brief Advances date registers by one day, including day of the week
+ *
+ * \param frame clock burst frame to be changed
+ */
+static void tick_date(uint8_t *frame)
+{
+    const uint8_t weekday = frame[DS1302_FRAME_WEEKDAY] & DS1302_WEEKDAY_MASK;
+
+    frame[DS1302_FRAME_WEEKDAY] = (weekday >= DS1302_SUNDAY) ? DS1302_MONDAY : (weekday + 1U);
+
+    const uint8_t year = frame[DS1302_FRAME_YEAR];
+    const uint8_t month = frame[DS1302_FRAME_MONTH] & DS1302_MONTH_MASK;
+    const uint8_t last = DS1302_get_date_range_maximum(DS1302_bcd_to_bin(year),
+            DS1302_bcd_to_bin(month));
+
+    if(DS1302_bcd_to_bin(frame[DS1302_FRAME_DATE] & DS1302_DATE_MASK) < last)
+    {
+        frame[DS1302_FRAME_DATE] = bcd_increment(frame[DS1302_FRAME_DATE] & DS1302_DATE_MASK);
+        return;
+    }
+
+    frame[DS1302_FRAME_DATE] = BCD_FIRST;
+
+    if(month < BCD_DECEMBER)
+    {
+        frame[DS1302_FRAME_MONTH] = bcd_increment(month);
+        return;
+    }
+
+    frame[DS1302_FRAME_MONTH] = BCD_FIRST;
+    frame[DS1302_FRAME_YEAR] = (year == BCD_LAST_YEAR) ? 0U : bcd_increment(year);
+}
+
+void DS1302_tick_frame(uint8_t *frame)
+{
+    if(frame == NULL)
+    {
+        ASSERT(false);
+        return;
+    }
+
+    const uint8_t halt = frame[DS1302_FRAME_SECONDS] & CLOCK_HALT_MASK;
+    const uint8_t secs = frame[DS1302_FRAME_SECONDS] & DS1302_SEC_MIN_MASK;
+
+    if(secs != BCD_LAST_MINUTE)
+    {
+        frame[DS1302_FRAME_SECONDS] = halt | bcd_increment(secs);
+        return;
+    }
+
+    frame[DS1302_FRAME_SECONDS] = halt;
+
+    const uint8_t min = frame[DS1302_FRAME_MINUTES] & DS1302_SEC_MIN_MASK;
+
+    if(min != BCD_LAST_MINUTE)
+    {
+        frame[DS1302_FRAME_MINUTES] = bcd_increment(min);
+        return;
+    }
+
+    frame[DS1302_FRAME_MINUTES] = 0U;
+
+    if(tick_hours(frame))
+    {
+        tick_date(frame);
+    }
+}
+
+/*!
+ * \brief Puts two decimal digits of the value into buffer
+ *
+ * \param buf buffer
+ * \param val value, "--" is put for values above 99, e.g. read from
+ * corrupted or unpowered device
+ *
+ * \returns Position in buffer after the digits
+ */
+static inline char *put_digits(char *buf, uint8_t val)
+{
+    if(val > TWO_DIGITS_MAXIMUM)
+    {
+        buf[0] = INVALID_DIGIT;
+        buf[1] = INVALID_DIGIT;
+
+        return buf + 2U;
+    }
+
+    buf[0] = (char)pgm_read_byte(&digit_pairs[2U*val]);
+    buf[1] = (char)pgm_read_byte(&digit_pairs[2U*val + 1U]);
+
+    return buf + 2U;
+}
+
+/*!
+ * \brief Puts two decimal digits of the BCD code into buffer
+ *
+ * \param buf buffer
+ * \param bcd BCD code, "--" is put if either nibble is above 9
+ *
+ * \returns Position in buffer after the digits
+ */
+static inline char *put_bcd_digits(char *buf, uint8_t bcd)
+{
+    if(((bcd >> TENS_SHIFT) > DIGIT_MAXIMUM) || ((bcd & UNITS_MASK) > DIGIT_MAXIMUM))
+    {
+        buf[0] = INVALID_DIGIT;
+        buf[1] = INVALID_DIGIT;
+
+        return buf + 2U;
+    }
+
+    buf[0] = (char)('0' + (bcd >> TENS_SHIFT));
+    buf[1] = (char)('0' + (bcd & UNITS_MASK));
+
+    return buf + 2U;
+}
+
+/*!
+ * \brief Puts three values separated with given character into buffer
+ *
+ * \param buf buffer
+ * \param first first value
+ * \param second second value
+ * \param third third value
+ * \param separator separator
+ *
+ * \returns Position in buffer after the last value
+ */
+static char *put_triple(char *buf, uint8_t first, uint8_t second, uint8_t third,
+        char separator)
+{
+    buf = put_digits(buf, first);
+    *buf++ = separator;
+    buf = put_digits(buf, second);
+    *buf++ = separator;
+
+    return put_digits(buf, third);
+}
+
+/*!
+ * \brief Puts three BCD codes separated with given character into buffer
+ *
+ * \param buf buffer
+ * \param first first BCD code
+ * \param second second BCD code
+ * \param third third BCD code
+ * \param separator separator
+ *
+ * \returns Position in buffer after the last code
+ */
+static char *put_bcd_triple(char *buf, uint8_t first, uint8_t second, uint8_t third,
+        char separator)
+{
+    buf = put_bcd_digits(buf, first);
+    *buf++ = separator;
+    buf = put_bcd_digits(buf, second);
+    *buf++ = separator;
+
+    return put_bcd_digits(buf, third);
+}
+
+/*!
+ * \brief Gets BCD code of hours kept in the clock burst frame
+ *
+ * \param frame clock burst frame
+ *
+ * \returns BCD code of hours, in format the device runs in
+ */
+static inline uint8_t get_frame_hours(const uint8_t *frame)
+{
+    const uint8_t value = frame[DS1302_FRAME_HOURS];
+
+    return value & (((value & DS1302_FORMAT_MASK) != 0U) ? DS1302_HOURS_12H_MASK :
+            DS1302_HOURS_24H_MASK);
+}
+
+char *DS1302_format_time(char *buf, const DS1302_datetime_t *config)
+{
+    if((buf == NULL) || (config == NULL))
+    {
+        ASSERT(false);
+        return buf;
+    }
+
+    buf = put_triple(buf, get_hours_24h(config), config->min, config->secs, ':');
+    *buf = '\0';
+
+    return buf;
+}
+
+char *DS1302_format_time_12h(char *buf, const DS1302_datetime_t *config)
+{
+    if((buf == NULL) || (config == NULL))
+    {
+        ASSERT(false);
+        return buf;
+    }
+
+    DS1302_datetime_t time = *config;
+
+    time.is_12h_mode = true;
+    set_hours_24h(&time, get_hours_24h(config));
+
+    buf = put_triple(buf, time.hours, time.min, time.secs, ':');
+    *buf++ = ' ';
+    *buf++ = time.is_pm ? 'P' : 'A';
+    *buf++ = 'M';
+    *buf = '\0';
+
+    return buf;
+}
+
+char *DS1302_format_date(char *buf, const DS1302_datetime_t *config)
+{
+    if((buf == NULL) || (config == NULL))
+    {
+        ASSERT(false);
+        return buf;
+    }
+
+    buf = put_triple(buf, config->date, config->month, config->year, '.');
+    *buf = '\0';
+
+    return buf;
+}
+
+char *DS1302_format_iso8601(char *buf, const DS1302_datetime_t *config)
+{
+    if((buf == NULL) || (config == NULL))
+    {
+        ASSERT(false);
+        return buf;
+    }
+
+    buf = put_digits(buf, CENTURY_DIGITS);
+    buf = put_triple(buf, config->year, config->month, config->date, '-');
+    *buf++ = 'T';
+    buf = put_triple(buf, get_hours_24h(config), config->min, config->secs, ':');
+    *buf = '\0';
+
+    return buf;
+}
+
+char *DS1302_format_frame_time(char *buf, const uint8_t *frame)
+{
+    if((buf == NULL) || (frame == NULL))
+    {
+        ASSERT(false);
+        return buf;
+    }
+
+    buf = put_bcd_triple(buf, get_frame_hours(frame),
+            frame[DS1302_FRAME_MINUTES] & DS1302_SEC_MIN_MASK,
+            frame[DS1302_FRAME_SECONDS] & DS1302_SEC_MIN_MASK, ':');
+    *buf = '\0';
+
+    return buf;
+}
+
+char *DS1302_format_frame_date(char *buf, const uint8_t *frame)
+{
+    if((buf == NULL) || (frame == NULL))
+    {
+        ASSERT(false);
+        return buf;
+    }
+
+    buf = put_bcd_triple(buf, frame[DS1302_FRAME_DATE] & DS1302_DATE_MASK,
+            frame[DS1302_FRAME_MONTH] & DS1302_MONTH_MASK, frame[DS1302_FRAME_YEAR], '.');
+    *buf = '\0';
+
+    return buf;
+}
+
+char *DS1302_format_frame_iso8601(char *buf, const uint8_t *frame)
+{
+    if((buf == NULL) || (frame == NULL))
+    {
+        ASSERT(false);
+        return buf;
+    }
+
+    buf = put_digits(buf, CENTURY_DIGITS);
+    buf = put_bcd_triple(buf, frame[DS1302_FRAME_YEAR],
+            frame[DS1302_FRAME_MONTH] & DS1302_MONTH_MASK,
+            frame[DS1302_FRAME_DATE] & DS1302_DATE_MASK, '-');
+    *buf++ = 'T';
+    buf = put_bcd_triple(buf, get_frame_hours(frame),
+            frame[DS1302_FRAME_MINUTES] & DS1302_SEC_MIN_MASK,
+            frame[DS1302_FRAME_SECONDS] & DS1302_SEC_MIN_MASK, ':');
+    *buf = '\0';
+
+    return buf;
+}
+
+/*!
+ * \brief Parses two decimal digits into BCD code and checks it against
+ * range of the data type
+ *
+ * \param str two digits to be parsed
+ * \param type data type \ref ds1302_data_types
+ * \param bcd storage for BCD code
+ *
+ * \retval true digits are valid and within range
+ * \retval false digits are invalid or out of range
+ */
+static bool parse_digits(const char *str, uint8_t type, uint8_t *bcd)
+{
+    const uint8_t tens = (uint8_t)(str[0] - '0');
+
+    if(tens > DIGIT_MAXIMUM)
+    {
+        return false;
+    }
+
+    const uint8_t units = (uint8_t)(str[1] - '0');
+
+    if(units > DIGIT_MAXIMUM)
+    {
+        return false;
+    }
+
+    *bcd = (uint8_t)(tens << TENS_SHIFT) | units;
+
+    /* BCD codes are ordered as binary values */
+    return (*bcd >= bin_to_bcd(pgm_read_byte(&fields[type].min))) &&
+        (*bcd <= bin_to_bcd(pgm_read_byte(&fields[type].max)));
+}
+
+/*!
+ * \brief Parses three groups of two digits separated by given characters
+ *
+ * \param str string to be parsed
+ * \param separators separators following first and second group, null if
+ * groups are not separated
+ * \param types data types of the groups
+ * \param bcd storage for three BCD codes
+ *
+ * \returns Position in the string after the last group, NULL if string is invalid
+ */
+static const char *parse_triple(const char *str, const char separators[2],
+        const uint8_t types[3], uint8_t *bcd)
+{
+    for(uint8_t i = 0U; i < 3U; i++)
+    {
+        if(!parse_digits(str, types[i], &bcd[i]))
+        {
+            return NULL;
+        }
+
+        str += 2U;
+
+        if((i < 2U) && (separators[i] != '\0'))
+        {
+            if(*str != separators[i])
+            {
+                return NULL;
+            }
+
+            str++;
+        }
+    }
+
+    return str;
+}
+
+/*!
+ * \brief Skips fraction of the second, which is not kept by DS1302
+ *
+ * \param str fraction digits following the decimal point
+ *
+ * \returns Position in the string after the digits, NULL if there are none
+ */
+static const char *skip_fraction(const char *str)
+{
+    const char *start = str;
+
+    while((*str >= '0') && (*str <= '9'))
+    {
+        str++;
+    }
+
+    return (str == start) ? NULL : str;
+}
+
+/*!
+ * \brief Parses time into clock burst frame
+ *
+ * \param str time to be parsed
+ * \param separator separator of the groups, null if groups are not separated
+ * \param frame clock burst frame to be updated
+ *
+ * \returns Position in the string after the time, NULL if time is invalid
+ */
+static const char *parse_time(const char *str, char separator, uint8_t *frame)
+{
+    static const uint8_t types[3] = { DS1302_HOURS_24H, DS1302_MINUTES, DS1302_SECONDS };
+    const char separators[2] = { separator, separator };
+    uint8_t bcd[3];
+
+    str = parse_triple(str, separators, types, bcd);
+
+    if(str != NULL)
+    {
+        frame[DS1302_FRAME_HOURS] = bcd[0];
+        frame[DS1302_FRAME_MINUTES] = bcd[1];
+        frame[DS1302_FRAME_SECONDS] = bcd[2];
+    }
+
+    return str;
+}
+
+/*!
+ * \brief Puts date into clock burst frame, after checking day of the month
+ * against length of the month
+ *
+ * \param year BCD code of the year
+ * \param month BCD code of the month
+ * \param date BCD code of the day of the month
+ * \param frame clock burst frame to be updated
+ *
+ * \retval true date is valid
+ * \retval false date is invalid
+ */
+static bool put_date(uint8_t year, uint8_t month, uint8_t date, uint8_t *frame)
+{
+    const uint8_t bin_year = DS1302_bcd_to_bin(year);
+    const uint8_t bin_month = DS1302_bcd_to_bin(month);
+    const uint8_t bin_date = DS1302_bcd_to_bin(date);
+
+    if(bin_date > DS1302_get_date_range_maximum(bin_year, bin_month))
+    {
+        return false;
+    }
+
+    frame[DS1302_FRAME_YEAR] = year;
+    frame[DS1302_FRAME_MONTH] = month;
+    frame[DS1302_FRAME_DATE] = date;
+    frame[DS1302_FRAME_WEEKDAY] = DS1302_compute_weekday(bin_year, bin_month, bin_date);
+
+    return true;
+}
+
+/*!
+ * \brief Converts time and date kept in clock burst frame into aggregate
+ *
+ * \param frame clock burst frame
+ * \param is_time true if time has to be converted
+ * \param is_date true if date has to be converted
+ * \param config aggregate to be updated
+ */
+static void put_parsed(const uint8_t *frame, bool is_time, bool is_date,
+        DS1302_datetime_t *config)
+{
+    if(is_time)
+    {
+        config->hours = DS1302_bcd_to_bin(frame[DS1302_FRAME_HOURS]);
+        config->min = DS1302_bcd_to_bin(frame[DS1302_FRAME_MINUTES]);
+        config->secs = DS1302_bcd_to_bin(frame[DS1302_FRAME_SECONDS]);
+        config->is_12h_mode = false;
+        config->is_pm = false;
+    }
+
+    if(is_date)
+    {
+        config->year = DS1302_bcd_to_bin(frame[DS1302_FRAME_YEAR]);
+        config->month = DS1302_bcd_to_bin(frame[DS1302_FRAME_MONTH]);
+        config->date = DS1302_bcd_to_bin(frame[DS1302_FRAME_DATE]);
+        config->weekday = frame[DS1302_FRAME_WEEKDAY];
+    }
+}
+
+bool DS1302_parse_iso8601_frame(const char *str, uint8_t *frame)
+{
+    static const uint8_t types[3] = { DS1302_YEAR, DS1302_MONTH, DS1302_DATE };
+    static const char separators[2] = { '-', '-' };
+    uint8_t bcd[3];
+    uint8_t century = 0U;
+
+    if((str == NULL) || (frame == NULL))
+    {
+        ASSERT(false);
+        return false;
+    }
+
+    if(!parse_digits(str, DS1302_YEAR, &century) || (century != bin_to_bcd(CENTURY_DIGITS)))
+    {
+        return false;
+    }
+
+    str = parse_triple(str + 2U, separators, types, bcd);
+
+    if((str == NULL) || ((*str != 'T') && (*str != ' ')))
+    {
+        return false;
+    }
+
+    uint8_t parsed[DS1302_FRAME_SIZE];
+
+    str = parse_time(str + 1U, ':', parsed);
+
+    if((str != NULL) && (*str == 'Z'))
+    {
+        str++;
+    }
+
+    if((str == NULL) || (*str != '\0') || !put_date(bcd[0], bcd[1], bcd[2], parsed))
+    {
+        return false;
+    }
+
+    parsed[DS1302_FRAME_CONTROL] = 0U;
+    memcpy(frame, parsed, DS1302_FRAME_SIZE);
+
+    return true;
+}
+
+bool DS1302_parse_iso8601(const char *str, DS1302_datetime_t *config)
+{
+    uint8_t frame[DS1302_FRAME_SIZE];
+
+    if(config == NULL)
+    {
+        ASSERT(false);
+        return false;
+    }
+
+    if(!DS1302_parse_iso8601_frame(str, frame))
+    {
+        return false;
+    }
+
+    put_parsed(frame, true, true, config);
+
+    return true;
+}
+
+bool DS1302_parse_time_frame(const char *str, uint8_t *frame)
+{
+    uint8_t parsed[DS1302_FRAME_SIZE];
+
+    if((str == NULL) || (frame == NULL))
+    {
+        ASSERT(false);
+        return false;
+    }
+
+    str = parse_time(str, '\0', parsed);
+
+    if((str != NULL) && (*str == '.'))
+    {
+        str = skip_fraction(str + 1U);
+    }
+
+    if((str == NULL) || (*str != '\0'))
+    {
+        return false;
+    }
+
+    frame[DS1302_FRAME_HOURS] = parsed[DS1302_FRAME_HOURS];
+    frame[DS1302_FRAME_MINUTES] = parsed[DS1302_FRAME_MINUTES];
+    frame[DS1302_FRAME_SECONDS] = parsed[DS1302_FRAME_SECONDS];
+
+    return true;
+}
+
+bool DS1302_parse_time(const char *str, DS1302_datetime_t *config)
+{
+    uint8_t frame[DS1302_FRAME_SIZE];
+
+    if(config == NULL)
+    {
+        ASSERT(false);
+        return false;
+    }
+
+    if(!DS1302_parse_time_frame(str, frame))
+    {
+        return false;
+    }
+
+    put_parsed(frame, true, false, config);
+
+    return true;
+}
+
+bool DS1302_parse_date_frame(const char *str, uint8_t *frame)
+{
+    static const uint8_t types[3] = { DS1302_DATE, DS1302_MONTH, DS1302_YEAR };
+    static const char separators[2] = { '\0', '\0' };
+    uint8_t bcd[3];
+
+    if((str == NULL) || (frame == NULL))
+    {
+        ASSERT(false);
+        return false;
+    }
+
+    str = parse_triple(str, separators, types, bcd);
+
+    if((str == NULL) || (*str != '\0'))
+    {
+        return false;
+    }
+
+    return put_date(bcd[2], bcd[1], bcd[0], frame);
+}
+
+bool DS1302_parse_date(const char *str, DS1302_datetime_t *config)
+{
+    uint8_t frame[DS1302_FRAME_SIZE];
+
+    if(config == NULL)
+    {
+        ASSERT(false);
+        return false;
+    }
+
+    if(!DS1302_parse_date_frame(str, frame))
+    {
+        return false;
+    }
+
+    put_parsed(frame, false, true, config);
+
+    return true;
+}
+
+void DS1302_set_write_protection(bool val)
+{
+    is_protection_requested = val;
+
+    if(!is_auto_protection() || (batch_depth == 0U))
+    {
+        write_protection(val);
+    }
+}
+
+bool DS1302_is_12h_mode(void)
+{
+    uint8_t value = 0U;
+
+    if(is_cached(CLOCK_SHADOW))
+    {
+        value = clock_shadow[DS1302_FRAME_HOURS];
+    }
+    else
+    {
+        value = read(READ_HOURS);
+    }
+
+    return get_value_to_load(DS1302_FORMAT, value);
+}
+
+void DS1302_set_hours_format(bool is_12h_mode)
+{
+    if(is_cached(CLOCK_SHADOW) &&
+            (get_value_to_load(DS1302_FORMAT, clock_shadow[DS1302_FRAME_HOURS]) == is_12h_mode))
+    {
+        return;
+    }
+
+    /* hours keep running, so the register is read instead of taken from the shadow */
+    const uint8_t value = read(READ_HOURS);
+    DS1302_datetime_t time = { 0 };
+
+    time.is_12h_mode = get_value_to_load(DS1302_FORMAT, value);
+
+    if(time.is_12h_mode == is_12h_mode)
+    {
+        clock_shadow[DS1302_FRAME_HOURS] = value;
+        return;
+    }
+
+    time.is_pm = get_value_to_load(DS1302_AM_PM, value);
+    time.hours = get_value_to_load(time.is_12h_mode ? DS1302_HOURS_12H : DS1302_HOURS_24H,
+            value);
+
+    if(is_12h_mode)
+    {
+        DS1302_to_12h_mode(&time);
+    }
+    else
+    {
+        DS1302_to_24h_mode(&time);
+    }
+
+    uint8_t hours = get_value_to_store(DS1302_FORMAT, is_12h_mode);
+
+    if(is_12h_mode)
+    {
+        hours |= get_value_to_store(DS1302_AM_PM, time.is_pm);
+        hours |= get_value_to_store(DS1302_HOURS_12H, time.hours);
+    }
+    else
+    {
+        hours |= get_value_to_store(DS1302_HOURS_24H, time.hours);
+    }
+
+    unlock();
+    write(WRITE_HOURS, hours);
+    update_clock_shadow(DS1302_FRAME_HOURS, hours);
+    relock();
+}
+
+void DS1302_set_trickle_charger(uint8_t setting)
+{
+    if(is_cached(TRICKLE_SHADOW) && (trickle_shadow == setting))
+    {
+        return;
+    }
+
+    unlock();
+    write_cached(WRITE_TRICKLE, &trickle_shadow, TRICKLE_SHADOW, setting);
+    relock();
+}
+
+uint8_t DS1302_get_trickle_charger(void)
+{
+    return read_cached(READ_TRICKLE, &trickle_shadow, TRICKLE_SHADOW);
+}
+
+void DS1302_invalidate_cache(void)
+{
+    shadow_valid = 0U;
+}
+
+void DS1302_configure(void)
+{
+    shadow_valid &= (uint8_t)~CONTROL_SHADOW;
+
+    const uint8_t control = read_cached(READ_WP, &control_shadow, CONTROL_SHADOW);
+    is_protection_requested = ((control & WRITE_PROTECTION_MASK) != 0U);
+
+#if DS1302_SEED_BUILD_TIMESTAMP
+    if((read(READ_SECONDS) & CLOCK_HALT_MASK) != 0U)
+    {
+        uint8_t frame[DS1302_FRAME_SIZE];
+
+        for(uint8_t i = 0U; i < DS1302_FRAME_SIZE; i++)
+        {
+            frame[i] = pgm_read_byte(&build_frame[i]);
+        }
+
+        /* oscillator is halted, so the clock has never been set */
+        shadow_valid &= (uint8_t)~CLOCK_SHADOW;
+        write_protection(false);
+        store_registers(frame);
+        write_protection(is_protection_requested);
+    }
+#endif
 }
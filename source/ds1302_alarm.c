@@ -0,0 +1,341 @@
+/*!
+ * \file
+ * \brief DS1302 alarm scheduler implementation file
+ * \author Dawid Babula
+ * \email dbabula@adventurous.pl
+ *
+ * \par Copyright (C) Dawid Babula, 2020
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#define DEBUG_APP_ID "DSAL"
+#define DEBUG_ENABLED   DEBUG_DS1302_ENABLED
+#define DEBUG_LEVEL     DEBUG_DS1302_LEVEL
+
+#include "ds1302_alarm.h"
+#include <stddef.h>
+#include "debug.h"
+
+/*!
+ *
+ * \addtogroup ds1302_alarm_constants
+ * \ingroup ds1302_alarm
+ * \brief DS1302 alarm scheduler constants
+ */
+/*@{*/
+#define SLOT_BITS               (4u)
+#define SLOTS                   (1u << SLOT_BITS)
+#define SLOT_MASK               (SLOTS - 1u)
+#define WHEEL_BITS              (DS1302_ALARM_LEVELS * SLOT_BITS)
+#define WHEEL_SPAN              (1UL << WHEEL_BITS)
+#define WHEEL_MASK              (WHEEL_SPAN - 1UL)
+/*@}*/
+
+#if (DS1302_ALARM_LEVELS < 1u) || (DS1302_ALARM_LEVELS > 7u)
+#error "DS1302_ALARM_LEVELS has to be within 1-7"
+#endif
+
+static DS1302_alarm_t *wheel[DS1302_ALARM_LEVELS][SLOTS];
+static DS1302_alarm_t *overflow;
+static DS1302_timestamp_t current;
+/*! List being cascaded, fired or rescheduled */
+static DS1302_alarm_t *detached;
+
+/*!
+ * \brief Links alarm at the head of the list
+ *
+ * \param list head of the list
+ * \param alarm alarm to be linked
+ */
+static void link_alarm(DS1302_alarm_t **list, DS1302_alarm_t *alarm)
+{
+    alarm->next = *list;
+
+    if(alarm->next != NULL)
+    {
+        alarm->next->pprev = &alarm->next;
+    }
+
+    alarm->pprev = list;
+    *list = alarm;
+}
+
+/*!
+ * \brief Unlinks alarm from the list it is kept on
+ *
+ * \param alarm alarm to be unlinked
+ */
+static void unlink_alarm(DS1302_alarm_t *alarm)
+{
+    *alarm->pprev = alarm->next;
+
+    if(alarm->next != NULL)
+    {
+        alarm->next->pprev = alarm->pprev;
+    }
+
+    alarm->next = NULL;
+    alarm->pprev = NULL;
+}
+
+/*!
+ * \brief Moves whole list onto \ref detached list, so it can be walked
+ * while alarms are being linked elsewhere
+ *
+ * \param list head of the list to be emptied
+ */
+static void detach(DS1302_alarm_t **list)
+{
+    detached = *list;
+    *list = NULL;
+
+    if(detached != NULL)
+    {
+        detached->pprev = &detached;
+    }
+}
+
+/*!
+ * \brief Links alarm into the lowest wheel level, which still spans its expiry
+ *
+ * \param alarm alarm, which expiry has to be later than current time or
+ * equal to it during cascading
+ */
+static void place(DS1302_alarm_t *alarm)
+{
+    const DS1302_timestamp_t expiry = alarm->expiry;
+
+    for(uint8_t level = 0U; level < DS1302_ALARM_LEVELS; level++)
+    {
+        const uint8_t shift = level * SLOT_BITS;
+
+        if(((expiry ^ current) >> (shift + SLOT_BITS)) == 0U)
+        {
+            link_alarm(&wheel[level][(expiry >> shift) & SLOT_MASK], alarm);
+            return;
+        }
+    }
+
+    link_alarm(&overflow, alarm);
+}
+
+/*!
+ * \brief Moves expiry of the alarm due already after current time
+ *
+ * \param alarm alarm to be updated
+ *
+ * \note Single shot alarm is moved to the next second, repeating alarm to
+ * its next occurrence
+ */
+static void catch_up(DS1302_alarm_t *alarm)
+{
+    if(alarm->expiry > current)
+    {
+        return;
+    }
+
+    if(alarm->period == DS1302_ALARM_ONCE)
+    {
+        alarm->expiry = current + 1U;
+        return;
+    }
+
+    const uint32_t periods = (current - alarm->expiry) / alarm->period + 1U;
+
+    alarm->expiry += periods * alarm->period;
+}
+
+/*!
+ * \brief Places again all alarms of the list
+ *
+ * \param list head of the list to be emptied
+ */
+static void cascade(DS1302_alarm_t **list)
+{
+    detach(list);
+
+    while(detached != NULL)
+    {
+        DS1302_alarm_t *alarm = detached;
+
+        unlink_alarm(alarm);
+        place(alarm);
+    }
+}
+
+/*!
+ * \brief Fires all alarms of the list, rearming repeating ones first
+ *
+ * \param list head of the list to be emptied
+ */
+static void fire(DS1302_alarm_t **list)
+{
+    detach(list);
+
+    while(detached != NULL)
+    {
+        DS1302_alarm_t *alarm = detached;
+
+        unlink_alarm(alarm);
+
+        if(alarm->period != DS1302_ALARM_ONCE)
+        {
+            alarm->expiry += alarm->period;
+            place(alarm);
+        }
+
+        alarm->callback(alarm->context);
+    }
+}
+
+/*!
+ * \brief Reschedules all pending alarms for new current time
+ *
+ * \param now new current time
+ */
+static void rebase(DS1302_timestamp_t now)
+{
+    for(uint8_t level = 0U; level < DS1302_ALARM_LEVELS; level++)
+    {
+        for(uint8_t slot = 0U; slot < SLOTS; slot++)
+        {
+            while(wheel[level][slot] != NULL)
+            {
+                DS1302_alarm_t *alarm = wheel[level][slot];
+
+                unlink_alarm(alarm);
+                link_alarm(&overflow, alarm);
+            }
+        }
+    }
+
+    detach(&overflow);
+    current = now;
+
+    while(detached != NULL)
+    {
+        DS1302_alarm_t *alarm = detached;
+
+        unlink_alarm(alarm);
+        catch_up(alarm);
+        place(alarm);
+    }
+}
+
+void DS1302_alarm_init(DS1302_timestamp_t now)
+{
+    for(uint8_t level = 0U; level < DS1302_ALARM_LEVELS; level++)
+    {
+        for(uint8_t slot = 0U; slot < SLOTS; slot++)
+        {
+            while(wheel[level][slot] != NULL)
+            {
+                unlink_alarm(wheel[level][slot]);
+            }
+        }
+    }
+
+    while(overflow != NULL)
+    {
+        unlink_alarm(overflow);
+    }
+
+    current = now;
+}
+
+void DS1302_alarm_start(DS1302_alarm_t *alarm, DS1302_timestamp_t expiry,
+        uint32_t period, DS1302_alarm_callback_t callback, void *context)
+{
+    if((alarm == NULL) || (callback == NULL))
+    {
+        ASSERT(false);
+        return;
+    }
+
+    if(alarm->pprev != NULL)
+    {
+        unlink_alarm(alarm);
+    }
+
+    alarm->expiry = expiry;
+    alarm->period = period;
+    alarm->callback = callback;
+    alarm->context = context;
+
+    catch_up(alarm);
+    place(alarm);
+}
+
+void DS1302_alarm_cancel(DS1302_alarm_t *alarm)
+{
+    if(alarm == NULL)
+    {
+        ASSERT(false);
+        return;
+    }
+
+    if(alarm->pprev != NULL)
+    {
+        unlink_alarm(alarm);
+    }
+}
+
+void DS1302_alarm_tick(void)
+{
+    current++;
+
+    if((current & WHEEL_MASK) == 0U)
+    {
+        cascade(&overflow);
+    }
+
+    for(uint8_t level = DS1302_ALARM_LEVELS - 1U; level > 0U; level--)
+    {
+        const uint8_t shift = level * SLOT_BITS;
+
+        if((current & ((1UL << shift) - 1UL)) == 0U)
+        {
+            cascade(&wheel[level][(current >> shift) & SLOT_MASK]);
+        }
+    }
+
+    fire(&wheel[0][current & SLOT_MASK]);
+}
+
+void DS1302_alarm_sync(DS1302_timestamp_t now)
+{
+    if(now == DS1302_TIMESTAMP_INVALID)
+    {
+        return;
+    }
+
+    if((now < current) || ((now - current) > WHEEL_SPAN))
+    {
+        rebase(now - 1U);
+        DS1302_alarm_tick();
+        return;
+    }
+
+    while(current != now)
+    {
+        DS1302_alarm_tick();
+    }
+}
+
+DS1302_timestamp_t DS1302_alarm_get_time(void)
+{
+    return current;
+}
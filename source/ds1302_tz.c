@@ -0,0 +1,250 @@
+/*!
+ * \file
+ * \brief DS1302 time zone implementation file
+ * \author Dawid Babula
+ * \email dbabula@adventurous.pl
+ *
+ * \par Copyright (C) Dawid Babula, 2020
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#define DEBUG_APP_ID "DSTZ"
+#define DEBUG_ENABLED   DEBUG_DS1302_ENABLED
+#define DEBUG_LEVEL     DEBUG_DS1302_LEVEL
+
+#include "ds1302_tz.h"
+#include <stddef.h>
+#include "debug.h"
+
+/*!
+ *
+ * \addtogroup ds1302_tz_constants
+ * \ingroup ds1302_tz
+ * \brief DS1302 time zone constants
+ */
+/*@{*/
+#define SECONDS_PER_MINUTE      (60L)
+#define DAYS_PER_WEEK           (7u)
+#define LAST_WEEK               (5u)
+#define MINUTES_PER_DAY         (1440u)
+#define MONTHS_PER_YEAR         (12u)
+#define TIMESTAMP_MAXIMUM       (UINT32_MAX)
+/*@}*/
+
+/*!
+ * \brief Shifts timestamp by given number of minutes, saturating at
+ * the beginning of the century
+ *
+ * \param timestamp timestamp to be shifted
+ * \param minutes minutes to be added
+ *
+ * \returns Shifted timestamp
+ */
+static DS1302_timestamp_t shift_timestamp(DS1302_timestamp_t timestamp, int32_t minutes)
+{
+    const int32_t secs = minutes * SECONDS_PER_MINUTE;
+
+    if((secs < 0) && (timestamp < (uint32_t)(-secs)))
+    {
+        return 0U;
+    }
+
+    return timestamp + (uint32_t)secs;
+}
+
+/*!
+ * \brief Checks if transition can be resolved into date
+ *
+ * \param transition transition
+ *
+ * \retval true all members are within range
+ * \retval false any member is out of range
+ */
+static bool is_transition_valid(const DS1302_tz_transition_t *transition)
+{
+    return (transition->month >= 1U) && (transition->month <= MONTHS_PER_YEAR) &&
+        (transition->week >= 1U) && (transition->week <= LAST_WEEK) &&
+        (transition->weekday >= DS1302_MONDAY) && (transition->weekday <= DS1302_SUNDAY) &&
+        (transition->minute < MINUTES_PER_DAY);
+}
+
+/*!
+ * \brief Gets UTC timestamp of the transition in given year
+ *
+ * \param transition transition
+ * \param year year
+ * \param offset offset of the local time in effect before transition in minutes
+ *
+ * \returns UTC timestamp of the transition
+ */
+static DS1302_timestamp_t get_transition(const DS1302_tz_transition_t *transition,
+        uint8_t year, int16_t offset)
+{
+    DS1302_datetime_t local = { 0 };
+    const uint8_t first = DS1302_compute_weekday(year, transition->month, 1U);
+    uint8_t date = 1U + (uint8_t)((transition->weekday + DAYS_PER_WEEK - first) % DAYS_PER_WEEK) +
+        DAYS_PER_WEEK * (transition->week - 1U);
+
+    if(date > DS1302_get_date_range_maximum(year, transition->month))
+    {
+        /* fifth occurrence does not exist, it means the last one */
+        date -= DAYS_PER_WEEK;
+    }
+
+    local.year = year;
+    local.month = transition->month;
+    local.date = date;
+
+    return shift_timestamp(DS1302_to_epoch(&local),
+            (int32_t)transition->minute - offset);
+}
+
+/*!
+ * \brief Computes offset in effect at given timestamp and interval it is
+ * valid within
+ *
+ * \param tz time zone state
+ * \param utc UTC timestamp
+ *
+ * \note Transitions of the previous, current and next year are taken into
+ * account, so the interval is found regardless of the hemisphere
+ */
+static void update(DS1302_tz_t *tz, DS1302_timestamp_t utc)
+{
+    const DS1302_tz_rule_t *rule = tz->rule;
+
+    if(!tz->has_dst)
+    {
+        tz->offset = rule->std_offset;
+        tz->is_dst = false;
+        tz->valid_from = 0U;
+        tz->valid_until = TIMESTAMP_MAXIMUM;
+        return;
+    }
+
+    DS1302_datetime_t now = { 0 };
+    DS1302_timestamp_t prev = 0U;
+    DS1302_timestamp_t next = TIMESTAMP_MAXIMUM;
+    bool has_prev = false;
+    bool is_prev_start = false;
+    bool is_next_start = false;
+
+    DS1302_from_epoch(utc, &now);
+
+    for(uint8_t i = 0U; i < 3U; i++)
+    {
+        const uint8_t year = now.year + i - 1U;
+
+        if(((now.year == 0U) && (i == 0U)) ||
+                (year > DS1302_get_range_maximum(DS1302_YEAR)))
+        {
+            continue;
+        }
+
+        for(uint8_t j = 0U; j < 2U; j++)
+        {
+            const bool is_start = (j == 0U);
+            const DS1302_timestamp_t transition = is_start ?
+                get_transition(&rule->dst_start, year, rule->std_offset) :
+                get_transition(&rule->dst_end, year, rule->dst_offset);
+
+            if(transition <= utc)
+            {
+                if(!has_prev || (transition >= prev))
+                {
+                    prev = transition;
+                    is_prev_start = is_start;
+                    has_prev = true;
+                }
+            }
+            else if(transition < next)
+            {
+                next = transition;
+                is_next_start = is_start;
+            }
+        }
+    }
+
+    tz->is_dst = has_prev ? is_prev_start : !is_next_start;
+    tz->offset = tz->is_dst ? rule->dst_offset : rule->std_offset;
+    tz->valid_from = prev;
+    tz->valid_until = next;
+}
+
+void DS1302_tz_init(DS1302_tz_t *tz, const DS1302_tz_rule_t *rule)
+{
+    if((tz == NULL) || (rule == NULL))
+    {
+        ASSERT(false);
+        return;
+    }
+
+    tz->rule = rule;
+    /* empty interval forces update on the first use */
+    tz->valid_from = TIMESTAMP_MAXIMUM;
+    tz->valid_until = 0U;
+    tz->offset = rule->std_offset;
+    tz->is_dst = false;
+    tz->has_dst = rule->has_dst;
+
+    if(rule->has_dst && (!is_transition_valid(&rule->dst_start) ||
+                !is_transition_valid(&rule->dst_end)))
+    {
+        /* standard time is used all year long */
+        ASSERT(false);
+        tz->has_dst = false;
+    }
+}
+
+int16_t DS1302_tz_get_offset(DS1302_tz_t *tz, DS1302_timestamp_t utc)
+{
+    if(tz == NULL)
+    {
+        ASSERT(false);
+        return 0;
+    }
+
+    if((utc >= tz->valid_until) || (utc < tz->valid_from))
+    {
+        update(tz, utc);
+    }
+
+    return tz->offset;
+}
+
+bool DS1302_tz_is_dst(DS1302_tz_t *tz, DS1302_timestamp_t utc)
+{
+    (void)DS1302_tz_get_offset(tz, utc);
+
+    return (tz != NULL) && tz->is_dst;
+}
+
+DS1302_timestamp_t DS1302_tz_to_local_timestamp(DS1302_tz_t *tz, DS1302_timestamp_t utc)
+{
+    return shift_timestamp(utc, DS1302_tz_get_offset(tz, utc));
+}
+
+void DS1302_tz_to_local(DS1302_tz_t *tz, const DS1302_datetime_t *utc,
+        DS1302_datetime_t *local)
+{
+    if((utc == NULL) || (local == NULL))
+    {
+        ASSERT(false);
+        return;
+    }
+
+    DS1302_unpack(DS1302_tz_to_local_timestamp(tz, DS1302_pack(utc)), local);
+}